@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <memory>
+
+#include "engine/fsm.h"
+#include "engine/state.h"
+#include "engine/transition.h"
+
+namespace {
+
+struct Context {
+  uint64_t ticks = 0;
+  uint64_t enter_count = 0;
+};
+
+class CountingState : public ng::State<Context> {
+ public:
+  using ng::State<Context>::State;
+
+ protected:
+  void OnEnter() override { ++GetContext()->enter_count; }
+
+  void Update() override { ++GetContext()->ticks; }
+};
+
+/// @brief Returns an FSM cycling through two states every period ticks.
+ng::FSM<Context> MakeTwoStateFSM(Context* context, uint64_t period) {
+  ng::FSM<Context> fsm(context, std::make_unique<CountingState>("first"));
+  fsm.AddState(std::make_unique<CountingState>("second"));
+  fsm.AddTransition({"first", "second", [period](const Context& c) -> bool {
+                       return c.ticks % period == 0;
+                     }});
+  fsm.AddTransition({"second", "first", [period](const Context& c) -> bool {
+                       return c.ticks % period == period / 2;
+                     }});
+  return fsm;
+}
+
+void BM_FSMUpdateNoTransition(benchmark::State& state) {
+  Context context;
+  // The period is never reached, so only the conditions are evaluated.
+  ng::FSM<Context> fsm = MakeTwoStateFSM(&context, UINT64_MAX);
+  context.ticks = 1;
+
+  for (auto _ : state) {
+    fsm.Update();
+  }
+  benchmark::DoNotOptimize(context.ticks);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FSMUpdateNoTransition);
+
+void BM_FSMUpdateTransitionEveryTick(benchmark::State& state) {
+  Context context;
+  ng::FSM<Context> fsm = MakeTwoStateFSM(&context, 2);
+
+  for (auto _ : state) {
+    fsm.Update();
+  }
+  benchmark::DoNotOptimize(context.enter_count);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FSMUpdateTransitionEveryTick);
+
+}  // namespace
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include <benchmark/benchmark.h>
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "engine/app.h"
+#include "engine/node.h"
+#include "engine/scene.h"
+
+namespace {
+
+static constexpr uint32_t kTps = 60;
+
+/// @brief The ends of a chain of nodes.
+struct Chain {
+  ng::Node* top = nullptr;
+  ng::Node* leaf = nullptr;
+};
+
+/// @brief Loads a scene whose root has a single chain of depth nodes.
+Chain LoadDeepScene(ng::App& app, int64_t depth) {
+  auto scene = std::make_unique<ng::Scene>(&app);
+  Chain chain;
+  chain.top = &scene->MakeChild<ng::Node>();
+  chain.leaf = chain.top;
+  for (int64_t i = 1; i < depth; ++i) {
+    chain.leaf = &chain.leaf->MakeChild<ng::Node>();
+  }
+  app.LoadScene(std::move(scene));
+  // Adds all the queued nodes to the scene.
+  app.RunTicks(1);
+  return chain;
+}
+
+/// @brief Loads a scene whose root has width direct children.
+void LoadWideScene(ng::App& app, int64_t width) {
+  auto scene = std::make_unique<ng::Scene>(&app);
+  for (int64_t i = 0; i < width; ++i) {
+    scene->MakeChild<ng::Node>();
+  }
+  app.LoadScene(std::move(scene));
+  app.RunTicks(1);
+}
+
+void BM_UpdateDeepTree(benchmark::State& state) {
+  ng::App app(kTps);
+  LoadDeepScene(app, state.range(0));
+
+  for (auto _ : state) {
+    app.RunTicks(1);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateDeepTree)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_UpdateWideTree(benchmark::State& state) {
+  ng::App app(kTps);
+  LoadWideScene(app, state.range(0));
+
+  for (auto _ : state) {
+    app.RunTicks(1);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateWideTree)->RangeMultiplier(8)->Range(64, 32768);
+
+void BM_UpdateMostlyPassiveTree(benchmark::State& state) {
+  ng::App app(kTps);
+  auto scene = std::make_unique<ng::Scene>(&app);
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    // Two out of three nodes are passive, like colliders and canvases.
+    scene->MakeChild<ng::Node>().SetTickEnabled(i % 3 == 0);
+  }
+  app.LoadScene(std::move(scene));
+  app.RunTicks(1);
+
+  for (auto _ : state) {
+    app.RunTicks(1);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_UpdateMostlyPassiveTree)->RangeMultiplier(8)->Range(64, 32768);
+
+void BM_DestroyAndAddChildren(benchmark::State& state) {
+  ng::App app(kTps);
+  auto scene = std::make_unique<ng::Scene>(&app);
+  ng::Node& parent = scene->MakeChild<ng::Node>();
+  std::vector<ng::Node*> children;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    children.push_back(&parent.MakeChild<ng::Node>());
+  }
+  app.LoadScene(std::move(scene));
+  app.RunTicks(1);
+
+  // Every tick a quarter of the children, spread across the parent, is
+  // replaced, like short-lived bullets or pickups.
+  size_t stride = 4;
+  size_t offset = 0;
+  for (auto _ : state) {
+    for (size_t i = offset; i < children.size(); i += stride) {
+      children[i]->Destroy();
+      children[i] = &parent.MakeChild<ng::Node>();
+    }
+    offset = (offset + 1) % stride;
+    app.RunTicks(1);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) /
+                          static_cast<int64_t>(stride));
+}
+BENCHMARK(BM_DestroyAndAddChildren)->RangeMultiplier(8)->Range(64, 32768);
+
+void BM_BuildAndUnloadScene(benchmark::State& state) {
+  ng::App app(kTps);
+  size_t chunk_count = 0;
+
+  for (auto _ : state) {
+    auto scene = std::make_unique<ng::Scene>(&app);
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      scene->MakeChild<ng::Node>().MakeChild<ng::Node>();
+    }
+    chunk_count = scene->GetNodeArena().GetChunkCount();
+    // Destroying the scene returns every node to the arena, which then
+    // releases its chunks at once.
+    scene.reset();
+  }
+  state.counters["arena_chunks"] = static_cast<double>(chunk_count);
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 2);
+}
+BENCHMARK(BM_BuildAndUnloadScene)->RangeMultiplier(8)->Range(64, 32768);
+
+void BM_GlobalTransformRecompute(benchmark::State& state) {
+  ng::App app(kTps);
+  Chain chain = LoadDeepScene(app, state.range(0));
+
+  float x = 0;
+  for (auto _ : state) {
+    // Moving the top of the chain invalidates the whole chain.
+    chain.top->SetLocalPosition({x, 0.F});
+    x += 1.F;
+    benchmark::DoNotOptimize(chain.leaf->GetGlobalPosition());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GlobalTransformRecompute)->RangeMultiplier(4)->Range(4, 1024);
+
+void BM_GlobalTransformDecompose(benchmark::State& state) {
+  ng::App app(kTps);
+  Chain chain = LoadDeepScene(app, state.range(0));
+
+  float x = 0;
+  for (auto _ : state) {
+    chain.top->SetLocalPosition({x, 0.F});
+    x += 1.F;
+    // Also decomposes the matrix of the leaf into position, rotation and scale.
+    benchmark::DoNotOptimize(chain.leaf->GetGlobalTransform().getRotation());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GlobalTransformDecompose)->Arg(64);
+
+void BM_GlobalTransformCached(benchmark::State& state) {
+  ng::App app(kTps);
+  Chain chain = LoadDeepScene(app, state.range(0));
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(chain.leaf->GetGlobalTransform().getPosition());
+  }
+}
+BENCHMARK(BM_GlobalTransformCached)->Arg(64);
+
+}  // namespace
\ No newline at end of file
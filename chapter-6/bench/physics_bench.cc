@@ -0,0 +1,414 @@
+#include <benchmark/benchmark.h>
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "engine/app.h"
+#include "engine/circle_collider.h"
+#include "engine/collider.h"
+#include "engine/collision_layer.h"
+#include "engine/physics.h"
+#include "engine/rectangle_collider.h"
+#include "engine/scene.h"
+
+namespace {
+
+static constexpr uint32_t kTps = 60;
+static constexpr sf::Vector2f kColliderSize = {32.F, 32.F};
+// Smaller than the collider size, so that each collider overlaps its neighbors.
+static constexpr float kColliderSpacing = 24.F;
+
+/// @brief A scene filled with a square grid of rectangle colliders.
+struct ColliderGrid {
+  ng::Scene* scene = nullptr;
+  std::vector<ng::RectangleCollider*> colliders;
+};
+
+/// @brief Loads a scene containing count colliders laid out on a square grid.
+ColliderGrid LoadColliderGrid(
+    ng::App& app, int64_t count,
+    ng::PhysicsBroadphase broadphase = ng::PhysicsBroadphase::kSpatialHash) {
+  auto scene = std::make_unique<ng::Scene>(&app, broadphase);
+  ColliderGrid grid;
+  grid.scene = scene.get();
+
+  auto side = static_cast<int64_t>(std::ceil(std::sqrt(count)));
+  for (int64_t i = 0; i < count; ++i) {
+    auto& collider = scene->MakeChild<ng::RectangleCollider>(kColliderSize);
+    collider.SetLocalPosition(
+        {static_cast<float>(i % side) * kColliderSpacing,
+         static_cast<float>(i / side) * kColliderSpacing});
+    grid.colliders.push_back(&collider);
+  }
+
+  app.LoadScene(std::move(scene));
+  // Adds the colliders to the physics world.
+  app.RunTicks(1);
+  return grid;
+}
+
+/// @brief Loads a scene containing count colliders scattered over a wide level, mostly small with a few long platforms, as in an outdoor map.
+ColliderGrid LoadSparseLevel(ng::App& app, int64_t count,
+                             ng::PhysicsBroadphase broadphase) {
+  auto scene = std::make_unique<ng::Scene>(&app, broadphase);
+  ColliderGrid grid;
+  grid.scene = scene.get();
+
+  // About one collider per 256 by 256 area, on a level four times wider than
+  // tall.
+  float height = std::sqrt(static_cast<float>(count) / 4.F) * 256.F;
+  std::minstd_rand random(42);
+  std::uniform_real_distribution<float> x(0.F, height * 4.F);
+  std::uniform_real_distribution<float> y(0.F, height);
+  std::uniform_real_distribution<float> side(16.F, 64.F);
+  for (int64_t i = 0; i < count; ++i) {
+    sf::Vector2f size = sf::Vector2f(side(random), side(random));
+    if (i % 16 == 0) {
+      size = {512.F, 32.F};
+    }
+    auto& collider = scene->MakeChild<ng::RectangleCollider>(size);
+    collider.SetLocalPosition({x(random), y(random)});
+    grid.colliders.push_back(&collider);
+  }
+
+  app.LoadScene(std::move(scene));
+  // Adds the colliders to the physics world.
+  app.RunTicks(1);
+  return grid;
+}
+
+/// @brief Returns the broadphase selected by the first argument of a benchmark, and names it in the report.
+ng::PhysicsBroadphase GetBroadphase(benchmark::State& state) {
+  auto broadphase = static_cast<ng::PhysicsBroadphase>(state.range(0));
+  switch (broadphase) {
+    case ng::PhysicsBroadphase::kScan:
+      state.SetLabel("scan");
+      break;
+    case ng::PhysicsBroadphase::kSpatialHash:
+      state.SetLabel("spatial_hash");
+      break;
+    case ng::PhysicsBroadphase::kDynamicTree:
+      state.SetLabel("dynamic_tree");
+      break;
+  }
+  return broadphase;
+}
+
+/// @brief Checks that the physics world finds the same overlaps as testing every pair of colliders, for a sample of the colliders.
+bool MatchesBruteForce(const ng::Physics& physics,
+                       const std::vector<ng::RectangleCollider*>& colliders) {
+  size_t stride = std::max<size_t>(colliders.size() / 64, 1);
+  for (size_t i = 0; i < colliders.size(); i += stride) {
+    const ng::RectangleCollider* collider = colliders[i];
+    std::vector<const ng::Collider*> expected;
+    for (const ng::RectangleCollider* other : colliders) {
+      if (other != collider && collider->CanCollideWith(*other) &&
+          static_cast<const ng::Collider*>(collider)->Collides(*other)) {
+        expected.push_back(other);
+      }
+    }
+
+    std::vector<const ng::Collider*> found = physics.Overlap(*collider);
+    std::ranges::sort(expected);
+    std::ranges::sort(found);
+    if (found != expected) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BM_OverlapStatic(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(physics.Overlap(*grid.colliders[i]));
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OverlapStatic)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_OverlapIntoVector(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // The vector keeps its memory across queries, as a member of a node would.
+  std::vector<const ng::Collider*> overlaps;
+  size_t i = 0;
+  for (auto _ : state) {
+    overlaps.clear();
+    physics.Overlap(*grid.colliders[i], overlaps);
+    benchmark::DoNotOptimize(overlaps.data());
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OverlapIntoVector)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_OverlapIntoArray(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // A collider of the grid overlaps at most eight neighbors.
+  std::array<const ng::Collider*, 8> overlaps{};
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        physics.Overlap(*grid.colliders[i], std::span(overlaps)));
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OverlapIntoArray)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_ForEachOverlap(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  size_t i = 0;
+  for (auto _ : state) {
+    size_t count = 0;
+    physics.ForEachOverlap(*grid.colliders[i],
+                           [&count](const ng::Collider&) { ++count; });
+    benchmark::DoNotOptimize(count);
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ForEachOverlap)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_AnyOverlap(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(physics.AnyOverlap(*grid.colliders[i]));
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_AnyOverlap)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_OverlapVirtualBruteForce(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+
+  // The reference for the scans of Physics: every pair is tested through the
+  // virtual Collides, reading the transforms of both colliders.
+  size_t i = 0;
+  for (auto _ : state) {
+    const ng::RectangleCollider* collider = grid.colliders[i];
+    size_t overlaps = 0;
+    for (const ng::RectangleCollider* other : grid.colliders) {
+      if (other != collider && collider->CanCollideWith(*other) &&
+          static_cast<const ng::Collider*>(collider)->Collides(*other)) {
+        ++overlaps;
+      }
+    }
+    benchmark::DoNotOptimize(overlaps);
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OverlapVirtualBruteForce)->RangeMultiplier(2)->Range(16, 128);
+
+void BM_OverlapScanned(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid =
+      LoadColliderGrid(app, state.range(0), ng::PhysicsBroadphase::kScan);
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // The scan goes through the collider store rather than a grid.
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(physics.Overlap(*grid.colliders[i]));
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OverlapScanned)->RangeMultiplier(2)->Range(16, 128);
+
+void BM_OverlapAllMoving(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  float direction = 1.F;
+  for (auto _ : state) {
+    // Every collider moves then queries, as every entity would in a tick.
+    for (ng::RectangleCollider* collider : grid.colliders) {
+      collider->Translate({direction, 0.F});
+    }
+    for (ng::RectangleCollider* collider : grid.colliders) {
+      benchmark::DoNotOptimize(physics.Overlap(*collider));
+    }
+    direction = -direction;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_OverlapAllMoving)->RangeMultiplier(4)->Range(16, 4096);
+
+void BM_OverlapFilteredByLayer(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // Like pickups, the colliders only collide with a layer none of them is on,
+  // so every query is rejected by the layers of the cells.
+  static constexpr auto kPickupLayer =
+      static_cast<ng::CollisionLayer>(1U << 1U);
+  for (ng::RectangleCollider* collider : grid.colliders) {
+    collider->SetCollisionCategory(kPickupLayer);
+    collider->SetCollisionMask(ng::CollisionLayer::kDefault);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(physics.Overlap(*grid.colliders[i]));
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_OverlapFilteredByLayer)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_SweepFastProjectile(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid = LoadColliderGrid(app, state.range(0));
+  auto& bullet = grid.scene->MakeChild<ng::CircleCollider>(4.F);
+  app.RunTicks(1);
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // A bullet fired at the grid from above, moving two colliders per tick.
+  auto side = static_cast<int64_t>(std::ceil(std::sqrt(state.range(0))));
+  float width = static_cast<float>(side) * kColliderSpacing;
+  sf::Vector2f displacement = {16.F, 48.F};
+  float x = 0;
+  for (auto _ : state) {
+    bullet.SetLocalPosition({x, -40.F});
+    benchmark::DoNotOptimize(physics.Sweep(bullet, displacement));
+    x += 7.F;
+    if (x >= width) {
+      x -= width;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SweepFastProjectile)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_BroadphaseDenseArena(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid =
+      LoadColliderGrid(app, state.range(1), GetBroadphase(state));
+  ng::Physics& physics = grid.scene->GetMutablePhysics();
+  if (!MatchesBruteForce(physics, grid.colliders)) {
+    state.SkipWithError("The broadphase missed or invented overlaps");
+    return;
+  }
+
+  // Every collider moves, then the contacts of the tick are found.
+  float direction = 1.F;
+  for (auto _ : state) {
+    for (ng::RectangleCollider* collider : grid.colliders) {
+      collider->Translate({direction, 0.F});
+    }
+    physics.UpdateContacts();
+    direction = -direction;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_BroadphaseDenseArena)
+    ->ArgsProduct({{0, 1, 2}, {100, 1000, 10000}})
+    ->ArgNames({"broadphase", "colliders"});
+
+void BM_BroadphaseSparseLevel(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid =
+      LoadSparseLevel(app, state.range(1), GetBroadphase(state));
+  ng::Physics& physics = grid.scene->GetMutablePhysics();
+  if (!MatchesBruteForce(physics, grid.colliders)) {
+    state.SkipWithError("The broadphase missed or invented overlaps");
+    return;
+  }
+
+  // One collider in ten walks, the rest is scenery, then the contacts of the
+  // tick are found.
+  float direction = 2.F;
+  for (auto _ : state) {
+    for (size_t i = 0; i < grid.colliders.size(); i += 10) {
+      grid.colliders[i]->Translate({direction, 0.F});
+    }
+    physics.UpdateContacts();
+    direction = -direction;
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_BroadphaseSparseLevel)
+    ->ArgsProduct({{0, 1, 2}, {100, 1000, 10000}})
+    ->ArgNames({"broadphase", "colliders"});
+
+void BM_QueryCircle(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid =
+      LoadSparseLevel(app, state.range(1), GetBroadphase(state));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // An explosion centered on each collider in turn.
+  std::vector<const ng::Collider*> hits;
+  size_t i = 0;
+  for (auto _ : state) {
+    hits.clear();
+    physics.QueryCircle(grid.colliders[i]->GetGlobalPosition(), 128.F,
+                        ng::CollisionLayer::kAll, hits);
+    benchmark::DoNotOptimize(hits.data());
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryCircle)
+    ->ArgsProduct({{0, 1, 2}, {100, 1000, 10000}})
+    ->ArgNames({"broadphase", "colliders"});
+
+void BM_QueryNearest(benchmark::State& state) {
+  ng::App app(kTps);
+  ColliderGrid grid =
+      LoadSparseLevel(app, state.range(1), GetBroadphase(state));
+  const ng::Physics& physics = grid.scene->GetPhysics();
+
+  // The four colliders nearest to each collider in turn, as an AI looking
+  // for targets would ask.
+  std::vector<const ng::Collider*> nearest;
+  size_t i = 0;
+  for (auto _ : state) {
+    nearest.clear();
+    physics.QueryNearest(grid.colliders[i]->GetGlobalPosition(), 4,
+                         std::numeric_limits<float>::infinity(),
+                         ng::CollisionLayer::kAll, nearest);
+    benchmark::DoNotOptimize(nearest.data());
+    i = (i + 1) % grid.colliders.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QueryNearest)
+    ->ArgsProduct({{0, 1, 2}, {100, 1000, 10000}})
+    ->ArgNames({"broadphase", "colliders"});
+
+}  // namespace
\ No newline at end of file
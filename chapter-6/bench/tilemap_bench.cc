@@ -0,0 +1,184 @@
+#include <benchmark/benchmark.h>
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cmath>
+#include <cstdint>
+
+#include "engine/app.h"
+#include "engine/collider.h"
+#include "engine/tile.h"
+#include "engine/tilemap.h"
+#include "engine/tileset.h"
+
+// The engine leaves the tile identifiers to its user.
+enum class TileID : uint64_t {  // NOLINT
+  kEmpty = 0,
+  kGround,
+};
+
+namespace {
+
+static constexpr uint32_t kTps = 60;
+static constexpr sf::Vector2u kTileSize = {32, 32};
+
+/// @brief Returns a tileset with an empty tile and a textured solid tile.
+ng::Tileset MakeTileset(const sf::Texture& texture) {
+  ng::Tileset tileset(kTileSize, &texture);
+  tileset.AddTile(ng::Tile(TileID::kEmpty));
+  tileset.AddTile(ng::Tile(TileID::kGround, sf::IntRect({0, 0}, {16, 16}),
+                           /*is_solid=*/true));
+  return tileset;
+}
+
+void BM_TilemapSetTile(benchmark::State& state) {
+  ng::App app(kTps);
+  sf::Texture texture;
+  auto side = static_cast<uint32_t>(state.range(0));
+  ng::Tilemap tilemap(&app, {side, side}, MakeTileset(texture));
+
+  uint32_t i = 0;
+  for (auto _ : state) {
+    sf::Vector2u position(i % side, (i / side) % side);
+    tilemap.SetTile(position, (i % 2 == 0) ? TileID::kGround : TileID::kEmpty);
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TilemapSetTile)->Arg(64)->Arg(1024);
+
+void BM_TilemapGetWorldTile(benchmark::State& state) {
+  ng::App app(kTps);
+  sf::Texture texture;
+  auto side = static_cast<uint32_t>(state.range(0));
+  ng::Tilemap tilemap(&app, {side, side}, MakeTileset(texture));
+  for (uint32_t y = 0; y < side; y += 2) {
+    for (uint32_t x = 0; x < side; ++x) {
+      tilemap.SetTile({x, y}, TileID::kGround);
+    }
+  }
+
+  sf::Vector2f world_size =
+      sf::Vector2f(tilemap.GetSize().componentWiseMul(kTileSize));
+  // A fixed stride across the map, as a moving entity probing tiles would.
+  sf::Vector2f stride = {37.F, 23.F};
+  sf::Vector2f position;
+  for (auto _ : state) {
+    if (tilemap.IsWithinWorldBounds(position)) {
+      benchmark::DoNotOptimize(tilemap.GetWorldTile(position).GetID());
+    }
+    position += stride;
+    if (position.x >= world_size.x) {
+      position.x -= world_size.x;
+    }
+    if (position.y >= world_size.y) {
+      position.y -= world_size.y;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TilemapGetWorldTile)->Arg(64)->Arg(1024);
+
+void BM_TilemapMoveAndCollide(benchmark::State& state) {
+  ng::App app(kTps);
+  sf::Texture texture;
+  auto side = static_cast<uint32_t>(state.range(0));
+  ng::Tilemap tilemap(&app, {side, side}, MakeTileset(texture));
+  // Floors every fourth row, with a wall every eighth column.
+  for (uint32_t y = 0; y < side; ++y) {
+    for (uint32_t x = 0; x < side; ++x) {
+      if (y % 4 == 3 || x % 8 == 7) {
+        tilemap.SetTile({x, y}, TileID::kGround);
+      }
+    }
+  }
+
+  // An enemy walking and falling, reset when it leaves the map.
+  sf::Vector2f size = {32.F, 32.F};
+  sf::Vector2f start = {32.F, 32.F};
+  sf::Vector2f position = start;
+  sf::Vector2f velocity = {2.F, 0.F};
+  for (auto _ : state) {
+    velocity.y += 1;
+    ng::TileMoveResult move =
+        tilemap.MoveAndCollide({position, size}, velocity);
+    if (move.hit_left || move.hit_right) {
+      velocity.x = -velocity.x;
+    }
+    velocity.y = move.velocity.y;
+    position = move.is_out_of_bounds ? start : move.bounds.position;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TilemapMoveAndCollide)->Arg(64)->Arg(1024);
+
+void BM_TilemapRaycast(benchmark::State& state) {
+  ng::App app(kTps);
+  sf::Texture texture;
+  auto side = static_cast<uint32_t>(state.range(0));
+  ng::Tilemap tilemap(&app, {side, side}, MakeTileset(texture));
+  // Sparse pillars, so that rays cross a few dozen tiles before hitting one.
+  for (uint32_t y = 0; y < side; y += 16) {
+    for (uint32_t x = 0; x < side; x += 16) {
+      tilemap.SetTile({x, y}, TileID::kGround);
+    }
+  }
+
+  sf::Vector2f world_size =
+      sf::Vector2f(tilemap.GetSize().componentWiseMul(kTileSize));
+  // Rays from a moving origin in a fan of directions, as line of sight checks.
+  sf::Vector2f stride = {37.F, 23.F};
+  sf::Vector2f origin = {16.F, 16.F};
+  float angle = 0;
+  for (auto _ : state) {
+    sf::Vector2f direction = {std::cos(angle), std::sin(angle)};
+    benchmark::DoNotOptimize(tilemap.Raycast(origin, direction, 1024.F));
+    angle += 0.1F;
+    origin += stride;
+    if (origin.x >= world_size.x) {
+      origin.x -= world_size.x;
+    }
+    if (origin.y >= world_size.y) {
+      origin.y -= world_size.y;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TilemapRaycast)->Arg(64)->Arg(1024);
+
+void BM_TilemapSweep(benchmark::State& state) {
+  ng::App app(kTps);
+  sf::Texture texture;
+  auto side = static_cast<uint32_t>(state.range(0));
+  ng::Tilemap tilemap(&app, {side, side}, MakeTileset(texture));
+  // Walls one tile thick every eighth column, that a fast bullet would skip.
+  for (uint32_t y = 0; y < side; ++y) {
+    for (uint32_t x = 7; x < side; x += 8) {
+      tilemap.SetTile({x, y}, TileID::kGround);
+    }
+  }
+
+  sf::Vector2f world_size =
+      sf::Vector2f(tilemap.GetSize().componentWiseMul(kTileSize));
+  // A bullet moving more than a tile per tick, from a moving origin.
+  ng::ColliderShape bullet = {.kind = ng::ColliderShape::Kind::kCircle,
+                              .center = {16.F, 16.F},
+                              .half_extents = {4.F, 4.F}};
+  sf::Vector2f displacement = {48.F, 12.F};
+  sf::Vector2f stride = {37.F, 23.F};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(tilemap.Sweep(bullet, displacement));
+    bullet.center += stride;
+    if (bullet.center.x >= world_size.x) {
+      bullet.center.x -= world_size.x;
+    }
+    if (bullet.center.y >= world_size.y) {
+      bullet.center.y -= world_size.y;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TilemapSweep)->Arg(64)->Arg(1024);
+
+}  // namespace
\ No newline at end of file
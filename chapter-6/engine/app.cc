@@ -6,24 +6,49 @@
 #include <SFML/Window/VideoMode.hpp>
 #include <chrono>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "input.h"
+#include "profiler.h"
 #include "resource_manager.h"
 #include "scene.h"
+#include "thread_pool.h"
 
 namespace ng {
 
+// The time spent each frame completing asynchronous resource loads, such as
+// texture uploads, so that a burst of loads does not cause a frame spike.
+static constexpr std::chrono::milliseconds kResourceFinalizeBudget(2);
+
 App::App(sf::Vector2u window_size, const sf::String& window_title, uint32_t tps,
          uint32_t fps)
     : window_(sf::RenderWindow(sf::VideoMode(window_size), window_title)),
       tps_(tps),
-      fps_(fps) {
+      fps_(fps),
+      resource_manager_(&thread_pool_) {
   window_.setFramerateLimit(fps_);
 }
 
+App::App(uint32_t tps)
+    : tps_(tps), is_headless_(true), resource_manager_(&thread_pool_) {}
+
+App::~App() {
+  if (scene_being_built_.valid()) {
+    discarded_scenes_.push_back(std::move(scene_being_built_));
+  }
+  // The factories may be waiting for this thread to upload their textures.
+  while (!discarded_scenes_.empty()) {
+    resource_manager_.FinalizePendingLoads(kResourceFinalizeBudget);
+    discarded_scenes_.front().wait_for(kResourceFinalizeBudget);
+    DestroyDiscardedScenes();
+  }
+}
+
 void App::Run() {
   auto previous = std::chrono::steady_clock::now();
   // Accumulator for unprocessed time.
@@ -36,39 +61,59 @@ void App::Run() {
     previous = current;
     lag += elapsed;
 
-    if (is_scene_unloading_scheduled_) {
-      scene_->InternalOnDestroy();
-      scene_ = nullptr;
-      is_scene_unloading_scheduled_ = false;
-    }
+    NG_PROFILE_SCOPE("App", "App::Frame");
+
+    ProcessScheduledScenes();
 
-    if (scheduled_scene_to_load_) {
-      scene_ = std::move(scheduled_scene_to_load_);
-      scene_->InternalOnAdd();
-      scheduled_scene_to_load_ = nullptr;
+    {
+      NG_PROFILE_SCOPE("App", "ResourceManager::FinalizePendingLoads");
+      resource_manager_.FinalizePendingLoads(kResourceFinalizeBudget);
     }
 
-    PollInput();
+    {
+      NG_PROFILE_SCOPE("App", "App::PollInput");
+      PollInput();
+    }
 
     // Process game logic updates based on the target TPS.
     while (lag >= NanosecondsPerTick()) {
-      if (scene_) {
-        scene_->InternalUpdate();
-      }
+      Tick();
       lag -= NanosecondsPerTick();
     }
 
-    window_.clear();
+    {
+      NG_PROFILE_SCOPE("App", "App::Draw");
+      window_.clear();
+
+      // Draw the current scene if it exists.
+      if (scene_) {
+        scene_->InternalDraw(window_);
+      }
+    }
 
-    // Draw the current scene if it exists.
-    if (scene_) {
-      scene_->InternalDraw(window_);
+    {
+      // Includes the wait of the framerate limit.
+      NG_PROFILE_SCOPE("App", "App::Display");
+      window_.display();
     }
+  }
+}
 
-    window_.display();
+void App::RunTicks(uint64_t ticks) {
+  for (uint64_t i = 0; i < ticks; ++i) {
+    ProcessScheduledScenes();
+    resource_manager_.FinalizePendingLoads(kResourceFinalizeBudget);
+    Tick();
+    // Advance after the tick, so that events fed between two calls are
+    // observed as key down/up during the next tick.
+    input_.Advance();
   }
 }
 
+bool App::IsHeadless() const {
+  return is_headless_;
+}
+
 std::chrono::duration<float> App::SecondsPerTick() const {
   using namespace std::chrono_literals;
   return std::chrono::duration<float>(1s) / tps_;  // NOLINT
@@ -87,19 +132,82 @@ ResourceManager& App::GetResourceManager() {
   return resource_manager_;
 }
 
+ThreadPool& App::GetThreadPool() {
+  return thread_pool_;
+}
+
 const Input& App::GetInput() const {
   return input_;
 }
 
+Input& App::GetMutableInput() {
+  return input_;
+}
+
 App& App::LoadScene(std::unique_ptr<Scene> scene) {
   scheduled_scene_to_load_ = std::move(scene);
+  // The most recent request wins.
+  if (scene_being_built_.valid()) {
+    discarded_scenes_.push_back(std::move(scene_being_built_));
+  }
   return *this;
 }
 
+void App::LoadSceneAsync(std::function<std::unique_ptr<Scene>()> factory) {
+  if (scene_being_built_.valid()) {
+    discarded_scenes_.push_back(std::move(scene_being_built_));
+  }
+  scene_being_built_ = thread_pool_.Submit(std::move(factory));
+}
+
+bool App::IsSceneLoading() const {
+  return scene_being_built_.valid();
+}
+
 void App::UnloadScene() {
   is_scene_unloading_scheduled_ = true;
 }
 
+void App::ProcessScheduledScenes() {
+  NG_PROFILE_SCOPE("App", "App::ProcessScheduledScenes");
+
+  DestroyDiscardedScenes();
+
+  if (scene_being_built_.valid() &&
+      scene_being_built_.wait_for(std::chrono::seconds(0)) ==
+          std::future_status::ready) {
+    scheduled_scene_to_load_ = scene_being_built_.get();
+  }
+
+  if (is_scene_unloading_scheduled_) {
+    scene_->InternalOnDestroy();
+    scene_ = nullptr;
+    is_scene_unloading_scheduled_ = false;
+  }
+
+  if (scheduled_scene_to_load_) {
+    scene_ = std::move(scheduled_scene_to_load_);
+    scene_->InternalOnAdd();
+    scheduled_scene_to_load_ = nullptr;
+  }
+}
+
+void App::DestroyDiscardedScenes() {
+  std::erase_if(discarded_scenes_, [](auto& scene_being_built) {
+    if (scene_being_built.wait_for(std::chrono::seconds(0)) !=
+        std::future_status::ready) {
+      return false;
+    }
+
+    try {
+      scene_being_built.get();
+    } catch (...) {  // NOLINT(bugprone-empty-catch)
+      // Nobody waits for a discarded scene.
+    }
+    return true;
+  });
+}
+
 void App::PollInput() {
   // Prepare the input handler for new events.
   input_.Advance();
@@ -118,4 +226,12 @@ void App::PollInput() {
   }
 }
 
+void App::Tick() {
+  NG_PROFILE_SCOPE("App", "App::Tick");
+
+  if (scene_) {
+    scene_->InternalUpdate();
+  }
+}
+
 }  // namespace ng
\ No newline at end of file
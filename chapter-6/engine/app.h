@@ -3,11 +3,15 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/System/String.hpp>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
+#include <vector>
 
 #include "input.h"
 #include "resource_manager.h"
 #include "scene.h"
+#include "thread_pool.h"
 
 namespace ng {
 
@@ -21,16 +25,31 @@ class App {
   /// @param fps The target frames per second (rendering updates).
   App(sf::Vector2u window_size, const sf::String& window_title, uint32_t tps,
       uint32_t fps);
-  ~App() = default;
+
+  /// @brief Constructs a headless App instance. No window is created, nothing is drawn and no window events are polled.
+  ///        Scenes are advanced explicitly through RunTicks.
+  /// @param tps The ticks per second the game logic is designed for. Only used to compute the tick duration.
+  explicit App(uint32_t tps);
+  /// @brief Waits for the scenes being built in the background, uploading the textures they load, and destroys them on the calling thread.
+  ~App();
 
   App(const App& other) = delete;
   App& operator=(const App& other) = delete;
   App(App&& other) = delete;
   App& operator=(App&& other) = delete;
 
-  /// @brief Runs the main game loop.
+  /// @brief Runs the main game loop until the window is closed. Has no effect in headless mode.
   void Run();
 
+  /// @brief Advances the current scene by a fixed number of ticks as fast as possible, without drawing or polling window events.
+  ///        Scheduled scene loads and unloads are processed before every tick.
+  /// @param ticks The number of ticks to simulate.
+  void RunTicks(uint64_t ticks);
+
+  /// @brief Returns whether the App was constructed without a window.
+  /// @return True if the App is headless, false otherwise.
+  [[nodiscard]] bool IsHeadless() const;
+
   /// @brief Returns the duration of a single game tick in seconds.
   /// @return The time elapsed per tick.
   [[nodiscard]] std::chrono::duration<float> SecondsPerTick() const;
@@ -40,29 +59,61 @@ class App {
   [[nodiscard]] std::chrono::nanoseconds NanosecondsPerTick() const;
 
   /// @brief Returns a constant reference to the SFML RenderWindow.
-  /// @return A constant reference to the game window object.
+  /// @return A constant reference to the game window object. In headless mode the window is never opened and its size is zero.
   [[nodiscard]] const sf::RenderWindow& GetWindow() const;
 
   /// @brief Returns a reference to the ResourceManager for managing game assets.
   /// @return A reference to the ResourceManager.
   [[nodiscard]] ResourceManager& GetResourceManager();
 
+  /// @brief Returns a reference to the ThreadPool running the background work of the App, such as asynchronous resource loads.
+  /// @return A reference to the ThreadPool.
+  [[nodiscard]] ThreadPool& GetThreadPool();
+
   /// @brief Returns a constant reference to the Input manager.
   /// @return A constant reference to the Input manager.
   [[nodiscard]] const Input& GetInput() const;
 
+  /// @brief Returns a mutable reference to the Input manager, allowing simulated events to be fed in headless mode.
+  /// @return A mutable reference to the Input manager.
+  [[nodiscard]] Input& GetMutableInput();
+
   /// @brief Loads a new scene, replacing the currently active one. The old scene (if any) will be unloaded in the next frame.
   /// @param scene A unique pointer to the new Scene to load. Ownership is transferred to the App. This pointer must not be null.
   /// @return A reference to the App instance for method chaining.
   App& LoadScene(std::unique_ptr<Scene> scene);
 
+  /// @brief Builds a scene on the thread pool while the current scene keeps running, then loads it at the beginning of the
+  ///        first frame after it is built, exactly like LoadScene. A later call to LoadScene or LoadSceneAsync discards the
+  ///        scene being built, which is destroyed on the main thread once built. Exceptions thrown by the factory are rethrown
+  ///        on the main thread when the scene would be loaded.
+  ///        The factory runs concurrently with the current scene, so it must only use thread-safe engine services, such as the
+  ///        ResourceManager, whose textures are uploaded by the main thread. Scenes and nodes are not registered anywhere until
+  ///        they are loaded, so constructing them is safe. Work that is not thread-safe belongs in Node::OnAdd: SFML sounds,
+  ///        for instance, register in their sf::SoundBuffer, which races with the sounds of the current scene.
+  /// @param factory The function building the scene. Must not return null.
+  void LoadSceneAsync(std::function<std::unique_ptr<Scene>()> factory);
+
+  /// @brief Returns whether a scene is being built by LoadSceneAsync.
+  /// @return True if a scene is being built in the background, false otherwise.
+  [[nodiscard]] bool IsSceneLoading() const;
+
   /// @brief Unloads the currently active scene. The unloading process will happen at the beginning of the next frame.
   void UnloadScene();
 
  private:
+  /// @brief Unloads and loads the scenes that were scheduled during the previous frame, including the scenes built in the background.
+  void ProcessScheduledScenes();
+
+  /// @brief Destroys the discarded scenes whose build has finished. Their exceptions are ignored.
+  void DestroyDiscardedScenes();
+
   /// @brief Polls for SFML window events and updates the input state.
   void PollInput();
 
+  /// @brief Advances the current scene, if any, by a single tick.
+  void Tick();
+
   // The main SFML render window.
   sf::RenderWindow window_;
 
@@ -70,6 +121,8 @@ class App {
   uint32_t tps_ = 0;
   // Target frames per second for rendering.
   uint32_t fps_ = 0;
+  // Flag indicating if the App runs without a window.
+  bool is_headless_ = false;
 
   // Manages game resources like textures and sounds.
   ResourceManager resource_manager_;
@@ -80,8 +133,15 @@ class App {
   std::unique_ptr<Scene> scene_;
   // A scene scheduled to be loaded in the next frame. Ownership is managed by the App. Can be null.
   std::unique_ptr<Scene> scheduled_scene_to_load_;
+  // The scene being built on the thread pool by LoadSceneAsync. Not valid if no scene is being built.
+  std::future<std::unique_ptr<Scene>> scene_being_built_;
+  // The scenes discarded while being built. Kept until built, so that they are destroyed on the main thread rather than by the worker releasing the last reference to them.
+  std::vector<std::future<std::unique_ptr<Scene>>> discarded_scenes_;
   // Flag indicating if the current scene is scheduled for unloading.
   bool is_scene_unloading_scheduled_ = false;
+
+  // Runs background work. Declared last so that it is destroyed first: its workers finish their current task and are joined before the resource manager and the scenes their tasks use are destroyed.
+  ThreadPool thread_pool_;
 };
 
 }  // namespace ng
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <vector>
+
+#include "collision_layer.h"
+
+namespace ng {
+
+class Collider;
+
+/// @brief An acceleration structure that finds the colliders whose bounds may overlap a region, so that the physics world does not test every collider.
+///        Implementations index colliders by their global bounds and collision category, and may report more candidates than strictly overlap.
+class Broadphase {
+ public:
+  Broadphase() = default;
+  virtual ~Broadphase() = default;
+
+  Broadphase(const Broadphase& other) = delete;
+  Broadphase& operator=(const Broadphase& other) = delete;
+  Broadphase(Broadphase&& other) = delete;
+  Broadphase& operator=(Broadphase&& other) = delete;
+
+  /// @brief Inserts a collider using its current global bounds and collision category.
+  /// @param collider A pointer to the Collider to insert. This pointer must not be null and the Collider must not be already inserted.
+  virtual void Insert(const Collider* collider) = 0;
+
+  /// @brief Removes a collider. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider to remove. This pointer must not be null.
+  virtual void Remove(const Collider* collider) = 0;
+
+  /// @brief Marks the bounds of a collider as stale. They are reindexed by the next call to Refresh. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider whose global transform changed. This pointer must not be null.
+  virtual void MarkDirty(const Collider* collider) = 0;
+
+  /// @brief Updates the collision category a collider is indexed by. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider whose category changed. This pointer must not be null.
+  virtual void UpdateCategory(const Collider* collider) = 0;
+
+  /// @brief Reindexes every collider marked dirty since the last refresh.
+  virtual void Refresh() = 0;
+
+  /// @brief Appends to `out` every collider whose indexed bounds may overlap the given bounds and whose category shares a layer with the mask.
+  ///        Each collider is appended at most once. Refresh must be called beforehand for the results to reflect the latest transforms.
+  /// @param bounds The world space bounds to query.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the candidate colliders are appended to.
+  virtual void Query(sf::FloatRect bounds, CollisionLayer mask,
+                     std::vector<const Collider*>& out) const = 0;
+};
+
+}  // namespace ng
\ No newline at end of file
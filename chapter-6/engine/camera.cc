@@ -13,7 +13,9 @@ namespace ng {
 Camera::Camera(App* app) : Camera(app, 0, Layer::kDefault) {}
 
 Camera::Camera(App* app, int32_t draw_order, Layer render_layers)
-    : Node(app), draw_order_(draw_order), render_layers_(render_layers) {}
+    : Node(app), draw_order_(draw_order), render_layers_(render_layers) {
+  SetDrawnDirectly(false);
+}
 
 const sf::View& Camera::GetView() const {
   return view_;
@@ -33,12 +35,12 @@ void Camera::SetViewSize(sf::Vector2f size) {
 
 void Camera::OnAdd() {
   SetViewSize(sf::Vector2f(GetApp()->GetWindow().getSize()));
-  view_.setCenter(GetGlobalTransform().getPosition());
+  view_.setCenter(GetGlobalPosition());
   GetScene()->GetCameraManager().AddCamera(this);
 }
 
 void Camera::Update() {
-  view_.setCenter(GetGlobalTransform().getPosition());
+  view_.setCenter(GetGlobalPosition());
 }
 
 void Camera::OnDestroy() {
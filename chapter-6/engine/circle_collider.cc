@@ -4,8 +4,10 @@
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #endif
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <algorithm>
+#include <optional>
 
 #include "app.h"
 #include "collider.h"
@@ -22,30 +24,46 @@ float CircleCollider::GetRadius() const {
   return radius_;
 }
 
+float CircleCollider::GetGlobalRadius() const {
+  sf::Vector2f scale = GetGlobalScale();
+  return radius_ * std::max(scale.x, scale.y);
+}
+
+sf::FloatRect CircleCollider::GetGlobalBounds() const {
+  float radius = GetGlobalRadius();
+  return {GetGlobalPosition() - sf::Vector2f(radius, radius),
+          sf::Vector2f(radius, radius) * 2.F};
+}
+
+ColliderShape CircleCollider::GetGlobalShape() const {
+  float radius = GetGlobalRadius();
+  return {.kind = ColliderShape::Kind::kCircle,
+          .center = GetGlobalPosition(),
+          .half_extents = {radius, radius}};
+}
+
+std::optional<sf::FloatRect> CircleCollider::GetLocalBounds() const {
+  return sf::FloatRect({-radius_, -radius_}, {radius_ * 2.F, radius_ * 2.F});
+}
+
 bool CircleCollider::Collides(const Collider& other) const {
   return other.Collides(*this);
 }
 
 bool CircleCollider::Collides(const CircleCollider& other) const {
-  float distanceSquared = (GetGlobalTransform().getPosition() -
-                           other.GetGlobalTransform().getPosition())
-                              .lengthSquared();
-  float combinedRadius =
-      (radius_ * std::max(GetGlobalTransform().getScale().x,
-                          GetGlobalTransform().getScale().y)) +
-      (other.radius_ * std::max(other.GetGlobalTransform().getScale().x,
-                                other.GetGlobalTransform().getScale().y));
+  float distanceSquared =
+      (GetGlobalPosition() - other.GetGlobalPosition()).lengthSquared();
+  float combinedRadius = GetGlobalRadius() + other.GetGlobalRadius();
   return distanceSquared <= combinedRadius * combinedRadius;
 }
 
 bool CircleCollider::Collides(const RectangleCollider& other) const {
-  sf::Vector2f pos = GetGlobalTransform().getPosition();
-  sf::Vector2f other_pos = other.GetGlobalTransform().getPosition();
+  sf::Vector2f pos = GetGlobalPosition();
+  sf::Vector2f other_pos = other.GetGlobalPosition();
   // Calculate the half-extents of the rectangle in world space.
-  float half_x =
-      (other.GetSize().x * other.GetGlobalTransform().getScale().x) / 2;
-  float half_y =
-      (other.GetSize().y * other.GetGlobalTransform().getScale().y) / 2;
+  sf::Vector2f other_scale = other.GetGlobalScale();
+  float half_x = (other.GetSize().x * other_scale.x) / 2;
+  float half_y = (other.GetSize().y * other_scale.y) / 2;
 
   // Find the closest point on the rectangle to the circle's center.
   float closest_x =
@@ -57,8 +75,7 @@ bool CircleCollider::Collides(const RectangleCollider& other) const {
   float diff_y = pos.y - closest_y;
   float distance_squared = (diff_x * diff_x) + (diff_y * diff_y);
 
-  float radius = radius_ * std::max(GetGlobalTransform().getScale().x,
-                                    GetGlobalTransform().getScale().y);
+  float radius = GetGlobalRadius();
   return distance_squared <= radius * radius;
 }
 
@@ -69,7 +86,7 @@ void CircleCollider::Draw(sf::RenderTarget& target) {
   shape.setOutlineThickness(2);
   shape.setFillColor(sf::Color::Transparent);
   shape.setOrigin(sf::Vector2f(radius_, radius_));
-  target.draw(shape, GetGlobalTransform().getTransform());
+  target.draw(shape, GetGlobalMatrix());
 }
 #endif
 
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
+#include <optional>
+
 #include "collider.h"
 
 namespace ng {
@@ -16,6 +19,18 @@ class CircleCollider : public Collider {
   /// @return The radius of the circle.
   [[nodiscard]] float GetRadius() const;
 
+  /// @brief Returns the axis-aligned bounding box of the collider in world space.
+  /// @return The world space bounds of the collider.
+  [[nodiscard]] sf::FloatRect GetGlobalBounds() const override;
+
+  /// @brief Returns the geometry of the collider in world space.
+  /// @return The world space shape of the collider.
+  [[nodiscard]] ColliderShape GetGlobalShape() const override;
+
+  /// @brief Returns the bounds of the collider in its local space, centered on its origin.
+  /// @return The local bounds of the collider.
+  [[nodiscard]] std::optional<sf::FloatRect> GetLocalBounds() const override;
+
   /// @brief Checks for collision with another Collider. Uses double-dispatch.
   /// @param other A constant reference to the other Collider.
   /// @return True if a collision occurs, false otherwise.
@@ -39,6 +54,10 @@ class CircleCollider : public Collider {
 #endif
 
  private:
+  /// @brief Returns the radius in world space, scaled by the largest component of the global scale.
+  /// @return The global radius.
+  [[nodiscard]] float GetGlobalRadius() const;
+
   // The radius of the circle collider.
   float radius_ = 0;
 };
@@ -1,11 +1,46 @@
 #include "collider.h"
 
+#include "collision_layer.h"
 #include "node.h"
 #include "scene.h"
 
 namespace ng {
 
-Collider::Collider(App* app) : Node(app) {}
+Collider::Collider(App* app) : Node(app) {
+  // Colliders are moved by their parent and have no Update logic.
+  SetTickEnabled(false);
+#ifdef NDEBUG
+  // Only debug builds draw the outlines of the colliders.
+  SetDrawnDirectly(false);
+#endif
+}
+
+CollisionLayer Collider::GetCollisionCategory() const {
+  return collision_category_;
+}
+
+void Collider::SetCollisionCategory(CollisionLayer category) {
+  collision_category_ = category;
+  if (physics_id_ != 0) {
+    GetScene()->GetMutablePhysics().UpdateColliderLayers(this);
+  }
+}
+
+CollisionLayer Collider::GetCollisionMask() const {
+  return collision_mask_;
+}
+
+void Collider::SetCollisionMask(CollisionLayer mask) {
+  collision_mask_ = mask;
+  if (physics_id_ != 0) {
+    GetScene()->GetMutablePhysics().UpdateColliderLayers(this);
+  }
+}
+
+bool Collider::CanCollideWith(const Collider& other) const {
+  return Intersects(collision_mask_, other.collision_category_) &&
+         Intersects(other.collision_mask_, collision_category_);
+}
 
 void Collider::OnAdd() {
   GetScene()->GetMutablePhysics().AddCollider(this);
@@ -15,4 +50,11 @@ void Collider::OnDestroy() {
   GetScene()->GetMutablePhysics().RemoveCollider(this);
 }
 
+void Collider::OnGlobalTransformChange() {
+  // The collider is only tracked by the physics world once it is part of a scene.
+  if (GetScene() != nullptr) {
+    GetScene()->GetMutablePhysics().MarkColliderDirty(this);
+  }
+}
+
 }  // namespace ng
\ No newline at end of file
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+
+#include "collision_layer.h"
 #include "node.h"
 
 namespace ng {
@@ -7,13 +13,64 @@ namespace ng {
 class CircleCollider;
 class RectangleCollider;
 
+/// @brief The geometry of a collider in world space, as tracked by the physics world.
+struct ColliderShape {
+  /// @brief The kinds of collider geometry.
+  enum class Kind : uint8_t {
+    /// @brief An axis-aligned rectangle.
+    kRectangle,
+    /// @brief A circle.
+    kCircle,
+  };
+
+  // The kind of geometry.
+  Kind kind = Kind::kRectangle;
+  // The center of the shape.
+  sf::Vector2f center;
+  // Half the size of a rectangle, or the radius of a circle on both axes.
+  sf::Vector2f half_extents;
+};
+
 /// @brief An abstract base class for all types of colliders used for physics interactions.
 class Collider : public Node {
+  // Physics needs to be able to assign the registration id and index, and to track the shape updates.
+  friend class Physics;
+
  public:
   /// @brief Constructs a Collider associated with a specific App instance.
   /// @param app A pointer to the App instance this collider belongs to. This pointer must not be null.
   explicit Collider(App* app);
 
+  /// @brief Returns the axis-aligned bounding box of the collider in world space.
+  /// @return The world space bounds of the collider.
+  [[nodiscard]] virtual sf::FloatRect GetGlobalBounds() const = 0;
+
+  /// @brief Returns the geometry of the collider in world space.
+  /// @return The world space shape of the collider.
+  [[nodiscard]] virtual ColliderShape GetGlobalShape() const = 0;
+
+  /// @brief Returns the collision layers this collider belongs to.
+  /// @return The CollisionLayer flags of the collider.
+  [[nodiscard]] CollisionLayer GetCollisionCategory() const;
+
+  /// @brief Sets the collision layers this collider belongs to.
+  /// @param category The new CollisionLayer flags of the collider.
+  void SetCollisionCategory(CollisionLayer category);
+
+  /// @brief Returns the collision layers this collider collides with.
+  /// @return The CollisionLayer flags the collider collides with.
+  [[nodiscard]] CollisionLayer GetCollisionMask() const;
+
+  /// @brief Sets the collision layers this collider collides with.
+  /// @param mask The new CollisionLayer flags the collider collides with.
+  void SetCollisionMask(CollisionLayer mask);
+
+  /// @brief Checks if the layers of two colliders allow them to collide. Two colliders can collide only if each one's mask contains a layer of the other's category.
+  ///        This check is much cheaper than Collides and is done by the physics world before it.
+  /// @param other A constant reference to the other Collider.
+  /// @return True if the colliders can collide, false otherwise.
+  [[nodiscard]] bool CanCollideWith(const Collider& other) const;
+
   /// @brief Checks for collision with another Collider.
   /// This method uses double-dispatch to call the correct overload based on the runtime type of 'other'.
   /// @param other A constant reference to the other Collider.
@@ -33,6 +90,19 @@ class Collider : public Node {
  protected:
   void OnAdd() override;
   void OnDestroy() override;
+  void OnGlobalTransformChange() override;
+
+ private:
+  // The order in which the collider was added to the physics world, starting at 1. 0 if the collider is not in a physics world.
+  uint64_t physics_id_ = 0;
+  // The index of the collider in the collider list of the physics world.
+  size_t physics_index_ = 0;
+  // Flag indicating if the shape of the collider is waiting to be refreshed by the physics world.
+  bool is_shape_dirty_ = false;
+  // The collision layers this collider belongs to.
+  CollisionLayer collision_category_ = CollisionLayer::kDefault;
+  // The collision layers this collider collides with.
+  CollisionLayer collision_mask_ = CollisionLayer::kAll;
 };
 
 }  // namespace ng
\ No newline at end of file
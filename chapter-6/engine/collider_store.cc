@@ -0,0 +1,250 @@
+#include "collider_store.h"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NG_COLLIDER_STORE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "collider.h"
+#include "collision_layer.h"
+
+namespace ng {
+
+size_t ColliderStore::GetSize() const {
+  return kinds_.size();
+}
+
+void ColliderStore::Add(const ColliderShape& shape, CollisionLayer category,
+                        CollisionLayer mask) {
+  min_x_.push_back(0);
+  min_y_.push_back(0);
+  max_x_.push_back(0);
+  max_y_.push_back(0);
+  center_x_.push_back(0);
+  center_y_.push_back(0);
+  radius_.push_back(0);
+  kinds_.push_back(shape.kind);
+  categories_.push_back(category);
+  masks_.push_back(mask);
+  SetShape(kinds_.size() - 1, shape);
+}
+
+void ColliderStore::Remove(size_t index) {
+  assert(index < GetSize());
+  auto swap_and_pop = [index](auto& array) {
+    array[index] = array.back();
+    array.pop_back();
+  };
+  swap_and_pop(min_x_);
+  swap_and_pop(min_y_);
+  swap_and_pop(max_x_);
+  swap_and_pop(max_y_);
+  swap_and_pop(center_x_);
+  swap_and_pop(center_y_);
+  swap_and_pop(radius_);
+  swap_and_pop(kinds_);
+  swap_and_pop(categories_);
+  swap_and_pop(masks_);
+}
+
+void ColliderStore::SetShape(size_t index, const ColliderShape& shape) {
+  assert(index < GetSize());
+  // The same operations as the bounds and tests of the colliders, so that
+  // both give bit-identical results.
+  min_x_[index] = shape.center.x - shape.half_extents.x;
+  min_y_[index] = shape.center.y - shape.half_extents.y;
+  max_x_[index] = shape.center.x + shape.half_extents.x;
+  max_y_[index] = shape.center.y + shape.half_extents.y;
+  center_x_[index] = shape.center.x;
+  center_y_[index] = shape.center.y;
+  radius_[index] =
+      shape.kind == ColliderShape::Kind::kCircle ? shape.half_extents.x : 0.F;
+  kinds_[index] = shape.kind;
+}
+
+void ColliderStore::SetLayers(size_t index, CollisionLayer category,
+                              CollisionLayer mask) {
+  assert(index < GetSize());
+  categories_[index] = category;
+  masks_[index] = mask;
+}
+
+sf::FloatRect ColliderStore::GetBounds(size_t index) const {
+  assert(index < GetSize());
+  return {{min_x_[index], min_y_[index]},
+          {max_x_[index] - min_x_[index], max_y_[index] - min_y_[index]}};
+}
+
+ColliderShape ColliderStore::GetShape(size_t index) const {
+  assert(index < GetSize());
+  return {.kind = kinds_[index],
+          .center = {center_x_[index], center_y_[index]},
+          .half_extents = {max_x_[index] - center_x_[index],
+                           max_y_[index] - center_y_[index]}};
+}
+
+bool ColliderStore::CanCollide(size_t first, size_t second) const {
+  return Intersects(masks_[first], categories_[second]) &&
+         Intersects(masks_[second], categories_[first]);
+}
+
+bool ColliderStore::Overlaps(size_t first, size_t second) const {
+  ColliderShape::Kind first_kind = kinds_[first];
+  ColliderShape::Kind second_kind = kinds_[second];
+  if (first_kind == ColliderShape::Kind::kCircle &&
+      second_kind == ColliderShape::Kind::kCircle) {
+    float diff_x = center_x_[first] - center_x_[second];
+    float diff_y = center_y_[first] - center_y_[second];
+    float combined_radius = radius_[first] + radius_[second];
+    return (diff_x * diff_x) + (diff_y * diff_y) <=
+           combined_radius * combined_radius;
+  }
+  if (first_kind == ColliderShape::Kind::kCircle) {
+    return OverlapsRectangleCircle(second, first);
+  }
+  if (second_kind == ColliderShape::Kind::kCircle) {
+    return OverlapsRectangleCircle(first, second);
+  }
+
+  return !(min_x_[first] > max_x_[second] || max_x_[first] < min_x_[second] ||
+           min_y_[first] > max_y_[second] || max_y_[first] < min_y_[second]);
+}
+
+bool ColliderStore::Overlaps(size_t index, const ColliderShape& shape) const {
+  assert(index < GetSize());
+  sf::Vector2f min = shape.center - shape.half_extents;
+  sf::Vector2f max = shape.center + shape.half_extents;
+  if (shape.kind == ColliderShape::Kind::kRectangle &&
+      kinds_[index] == ColliderShape::Kind::kRectangle) {
+    return !(min_x_[index] > max.x || max_x_[index] < min.x ||
+             min_y_[index] > max.y || max_y_[index] < min.y);
+  }
+
+  if (shape.kind == ColliderShape::Kind::kCircle &&
+      kinds_[index] == ColliderShape::Kind::kCircle) {
+    float diff_x = center_x_[index] - shape.center.x;
+    float diff_y = center_y_[index] - shape.center.y;
+    float combined_radius = radius_[index] + shape.half_extents.x;
+    return (diff_x * diff_x) + (diff_y * diff_y) <=
+           combined_radius * combined_radius;
+  }
+
+  // Find the closest point on the rectangle to the circle's center.
+  bool is_circle_stored = kinds_[index] == ColliderShape::Kind::kCircle;
+  sf::Vector2f center = is_circle_stored
+                            ? sf::Vector2f(center_x_[index], center_y_[index])
+                            : shape.center;
+  float radius = is_circle_stored ? radius_[index] : shape.half_extents.x;
+  if (!is_circle_stored) {
+    min = {min_x_[index], min_y_[index]};
+    max = {max_x_[index], max_y_[index]};
+  }
+  float diff_x = center.x - std::max(min.x, std::min(center.x, max.x));
+  float diff_y = center.y - std::max(min.y, std::min(center.y, max.y));
+  return (diff_x * diff_x) + (diff_y * diff_y) <= radius * radius;
+}
+
+float ColliderStore::GetDistance(size_t index, sf::Vector2f point) const {
+  assert(index < GetSize());
+  if (kinds_[index] == ColliderShape::Kind::kCircle) {
+    float diff_x = point.x - center_x_[index];
+    float diff_y = point.y - center_y_[index];
+    return std::max(std::hypot(diff_x, diff_y) - radius_[index], 0.F);
+  }
+
+  float diff_x =
+      point.x - std::max(min_x_[index], std::min(point.x, max_x_[index]));
+  float diff_y =
+      point.y - std::max(min_y_[index], std::min(point.y, max_y_[index]));
+  return std::hypot(diff_x, diff_y);
+}
+
+bool ColliderStore::OverlapsRectangleCircle(size_t rectangle,
+                                            size_t circle) const {
+  // Find the closest point on the rectangle to the circle's center.
+  float closest_x = std::max(
+      min_x_[rectangle], std::min(center_x_[circle], max_x_[rectangle]));
+  float closest_y = std::max(
+      min_y_[rectangle], std::min(center_y_[circle], max_y_[rectangle]));
+
+  float diff_x = center_x_[circle] - closest_x;
+  float diff_y = center_y_[circle] - closest_y;
+  float radius = radius_[circle];
+  return (diff_x * diff_x) + (diff_y * diff_y) <= radius * radius;
+}
+
+void ColliderStore::QueryBounds(sf::FloatRect bounds, CollisionLayer mask,
+                                std::vector<size_t>& out) const {
+  Scan(bounds.position.x, bounds.position.y,
+       bounds.position.x + bounds.size.x, bounds.position.y + bounds.size.y,
+       mask, 0, out);
+}
+
+void ColliderStore::FindOverlaps(size_t index, size_t first_other,
+                                 std::vector<size_t>& out) const {
+  assert(index < GetSize());
+  size_t begin = out.size();
+  Scan(min_x_[index], min_y_[index], max_x_[index], max_y_[index],
+       masks_[index], first_other, out);
+  auto end = std::remove_if(
+      out.begin() + static_cast<std::ptrdiff_t>(begin), out.end(),
+      [this, index](size_t other) -> bool {
+        return other == index || !CanCollide(index, other) ||
+               !Overlaps(index, other);
+      });
+  out.erase(end, out.end());
+}
+
+void ColliderStore::Scan(float min_x, float min_y, float max_x, float max_y,
+                         CollisionLayer mask, size_t first,
+                         std::vector<size_t>& out) const {
+  size_t size = GetSize();
+  size_t i = first;
+#ifdef NG_COLLIDER_STORE_SSE2
+  const __m128 query_min_x = _mm_set1_ps(min_x);
+  const __m128 query_min_y = _mm_set1_ps(min_y);
+  const __m128 query_max_x = _mm_set1_ps(max_x);
+  const __m128 query_max_y = _mm_set1_ps(max_y);
+  const __m128i layers = _mm_set1_epi32(static_cast<int32_t>(mask));
+  const __m128i zero = _mm_setzero_si128();
+  for (; i + 4 <= size; i += 4) {
+    // Touching boxes overlap, as in the collider tests.
+    __m128 overlaps = _mm_and_ps(
+        _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&min_x_[i]), query_max_x),
+                   _mm_cmpge_ps(_mm_loadu_ps(&max_x_[i]), query_min_x)),
+        _mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&min_y_[i]), query_max_y),
+                   _mm_cmpge_ps(_mm_loadu_ps(&max_y_[i]), query_min_y)));
+    __m128i categories =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(&categories_[i]));
+    __m128i is_filtered =
+        _mm_cmpeq_epi32(_mm_and_si128(categories, layers), zero);
+    auto hits = static_cast<uint32_t>(_mm_movemask_ps(
+        _mm_andnot_ps(_mm_castsi128_ps(is_filtered), overlaps)));
+    while (hits != 0) {
+      out.push_back(i + static_cast<size_t>(std::countr_zero(hits)));
+      hits &= hits - 1;
+    }
+  }
+#endif
+  // The remaining entries, or all of them without SSE2.
+  for (; i < size; ++i) {
+    if (min_x_[i] <= max_x && max_x_[i] >= min_x &&
+        min_y_[i] <= max_y && max_y_[i] >= min_y &&
+        Intersects(categories_[i], mask)) {
+      out.push_back(i);
+    }
+  }
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "collider.h"
+#include "collision_layer.h"
+
+namespace ng {
+
+/// @brief Stores the world space shapes and collision layers of the colliders of a physics world as a structure of arrays.
+///        Entries are addressed by index and tested without touching the colliders, so that scans run over contiguous memory.
+class ColliderStore {
+ public:
+  /// @brief Returns the number of entries in the store.
+  /// @return The number of stored colliders.
+  [[nodiscard]] size_t GetSize() const;
+
+  /// @brief Appends an entry at the end of the store, at index GetSize() - 1.
+  /// @param shape The world space shape of the collider.
+  /// @param category The collision layers the collider belongs to.
+  /// @param mask The collision layers the collider collides with.
+  void Add(const ColliderShape& shape, CollisionLayer category,
+           CollisionLayer mask);
+
+  /// @brief Removes an entry by moving the last entry in its place.
+  /// @param index The index of the entry to remove. Must be less than GetSize().
+  void Remove(size_t index);
+
+  /// @brief Replaces the shape of an entry.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @param shape The new world space shape of the collider.
+  void SetShape(size_t index, const ColliderShape& shape);
+
+  /// @brief Replaces the collision layers of an entry.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @param category The collision layers the collider belongs to.
+  /// @param mask The collision layers the collider collides with.
+  void SetLayers(size_t index, CollisionLayer category, CollisionLayer mask);
+
+  /// @brief Returns the axis-aligned bounding box of an entry.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @return The world space bounds of the entry.
+  [[nodiscard]] sf::FloatRect GetBounds(size_t index) const;
+
+  /// @brief Returns the shape of an entry.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @return The world space shape of the entry.
+  [[nodiscard]] ColliderShape GetShape(size_t index) const;
+
+  /// @brief Checks if the layers of two entries allow them to collide, with the same rule as Collider::CanCollideWith.
+  /// @param first The index of the first entry. Must be less than GetSize().
+  /// @param second The index of the second entry. Must be less than GetSize().
+  /// @return True if the entries can collide, false otherwise.
+  [[nodiscard]] bool CanCollide(size_t first, size_t second) const;
+
+  /// @brief Checks if the shapes of two entries overlap, with the same results as Collider::Collides.
+  /// @param first The index of the first entry. Must be less than GetSize().
+  /// @param second The index of the second entry. Must be less than GetSize().
+  /// @return True if the shapes overlap, false otherwise.
+  [[nodiscard]] bool Overlaps(size_t first, size_t second) const;
+
+  /// @brief Checks if the shape of an entry overlaps a world space shape, with the same rules as the tests between entries.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @param shape The world space shape to test.
+  /// @return True if the shapes overlap, false otherwise.
+  [[nodiscard]] bool Overlaps(size_t index, const ColliderShape& shape) const;
+
+  /// @brief Returns the distance from a point to the shape of an entry.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @param point The world space point.
+  /// @return The distance from the point to the closest point of the shape, 0 if the point is inside the shape.
+  [[nodiscard]] float GetDistance(size_t index, sf::Vector2f point) const;
+
+  /// @brief Appends to `out` the index of every entry whose bounding box overlaps the given bounds and whose category shares a layer with the mask.
+  ///        Scans every entry, four at a time when SSE2 is available.
+  /// @param bounds The world space bounds to query.
+  /// @param mask The collision layers of the entries to report.
+  /// @param out The vector the indices are appended to, in increasing order.
+  void QueryBounds(sf::FloatRect bounds, CollisionLayer mask,
+                   std::vector<size_t>& out) const;
+
+  /// @brief Appends to `out` the index of every other entry that can collide with and overlaps the given entry, among the entries from a given index.
+  ///        The entries before that index are not tested at all, so that each pair is tested once when every entry looks only at the entries after it.
+  /// @param index The index of the entry. Must be less than GetSize().
+  /// @param first_other The index of the first entry to test against the given entry.
+  /// @param out The vector the indices are appended to, in increasing order.
+  void FindOverlaps(size_t index, size_t first_other,
+                    std::vector<size_t>& out) const;
+
+ private:
+  /// @brief Appends to `out` the index of every entry whose bounding box overlaps the given box and whose category shares a layer with the mask.
+  /// @param min_x The left edge of the box.
+  /// @param min_y The top edge of the box.
+  /// @param max_x The right edge of the box.
+  /// @param max_y The bottom edge of the box.
+  /// @param mask The collision layers of the entries to report.
+  /// @param first The index of the first entry to scan.
+  /// @param out The vector the indices are appended to, in increasing order.
+  void Scan(float min_x, float min_y, float max_x, float max_y,
+            CollisionLayer mask, size_t first, std::vector<size_t>& out) const;
+
+  /// @brief Checks if a rectangle entry and a circle entry overlap.
+  /// @param rectangle The index of the rectangle entry.
+  /// @param circle The index of the circle entry.
+  /// @return True if the shapes overlap, false otherwise.
+  [[nodiscard]] bool OverlapsRectangleCircle(size_t rectangle,
+                                             size_t circle) const;
+
+  // The bounding boxes of the entries, one array per component.
+  std::vector<float> min_x_;
+  std::vector<float> min_y_;
+  std::vector<float> max_x_;
+  std::vector<float> max_y_;
+  // The centers of the shapes, used by the circle tests.
+  std::vector<float> center_x_;
+  std::vector<float> center_y_;
+  // The radii of the circles, 0 for rectangles.
+  std::vector<float> radius_;
+  // The kinds of the shapes.
+  std::vector<ColliderShape::Kind> kinds_;
+  // The collision layers the entries belong to.
+  std::vector<CollisionLayer> categories_;
+  // The collision layers the entries collide with.
+  std::vector<CollisionLayer> masks_;
+};
+
+}  // namespace ng
\ No newline at end of file
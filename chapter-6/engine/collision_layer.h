@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ng {
+
+/// @brief Defines bitmask flags for collision layers, allowing selective collision between colliders.
+///        Games define their own layers as single bits and combine them into masks with operator|.
+enum class CollisionLayer : uint32_t {  // NOLINT
+  /// @brief No layer. A mask of kNone collides with nothing.
+  kNone = 0,
+  /// @brief The default collision layer.
+  kDefault = 1U << 0U,
+  /// @brief Every layer. A mask of kAll collides with everything.
+  kAll = ~0U,
+};
+
+/// @brief Combines two sets of collision layers.
+/// @param lhs The first set of layers.
+/// @param rhs The second set of layers.
+/// @return The layers belonging to either set.
+[[nodiscard]] constexpr CollisionLayer operator|(CollisionLayer lhs,
+                                                 CollisionLayer rhs) {
+  return static_cast<CollisionLayer>(static_cast<uint32_t>(lhs) |
+                                     static_cast<uint32_t>(rhs));
+}
+
+/// @brief Intersects two sets of collision layers.
+/// @param lhs The first set of layers.
+/// @param rhs The second set of layers.
+/// @return The layers belonging to both sets.
+[[nodiscard]] constexpr CollisionLayer operator&(CollisionLayer lhs,
+                                                 CollisionLayer rhs) {
+  return static_cast<CollisionLayer>(static_cast<uint32_t>(lhs) &
+                                     static_cast<uint32_t>(rhs));
+}
+
+/// @brief Checks if two sets of collision layers share at least one layer.
+/// @param lhs The first set of layers.
+/// @param rhs The second set of layers.
+/// @return True if a layer belongs to both sets, false otherwise.
+[[nodiscard]] constexpr bool Intersects(CollisionLayer lhs,
+                                        CollisionLayer rhs) {
+  return (lhs & rhs) != CollisionLayer::kNone;
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "dynamic_aabb_tree.h"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "collider.h"
+#include "collision_layer.h"
+
+namespace ng {
+
+namespace {
+
+/// @brief Returns the perimeter of a box, the cost the tree minimizes: the larger the boxes, the more queries reach them.
+/// @param min The top left corner of the box.
+/// @param max The bottom right corner of the box.
+/// @return The perimeter of the box.
+float Perimeter(sf::Vector2f min, sf::Vector2f max) {
+  return 2.F * ((max.x - min.x) + (max.y - min.y));
+}
+
+/// @brief Returns the top left corner of the union of two boxes.
+/// @param lhs The top left corner of the first box.
+/// @param rhs The top left corner of the second box.
+/// @return The top left corner of the union.
+sf::Vector2f UnionMin(sf::Vector2f lhs, sf::Vector2f rhs) {
+  return {std::min(lhs.x, rhs.x), std::min(lhs.y, rhs.y)};
+}
+
+/// @brief Returns the bottom right corner of the union of two boxes.
+/// @param lhs The bottom right corner of the first box.
+/// @param rhs The bottom right corner of the second box.
+/// @return The bottom right corner of the union.
+sf::Vector2f UnionMax(sf::Vector2f lhs, sf::Vector2f rhs) {
+  return {std::max(lhs.x, rhs.x), std::max(lhs.y, rhs.y)};
+}
+
+}  // namespace
+
+DynamicAabbTree::DynamicAabbTree(float margin) : margin_(margin) {
+  assert(margin >= 0);
+}
+
+void DynamicAabbTree::Insert(const Collider* collider) {
+  assert(collider);
+  int32_t leaf = AllocateNode();
+  [[maybe_unused]] auto [it, inserted] = leaves_.insert({collider, leaf});
+  assert(inserted);
+
+  TreeNode& node = nodes_[leaf];
+  node.collider = collider;
+  node.categories = collider->GetCollisionCategory();
+  node.height = 0;
+  FattenLeaf(leaf);
+  InsertLeaf(leaf);
+}
+
+void DynamicAabbTree::Remove(const Collider* collider) {
+  assert(collider);
+  auto it = leaves_.find(collider);
+  if (it == leaves_.end()) {
+    return;
+  }
+
+  int32_t leaf = it->second;
+  if (nodes_[leaf].is_dirty) {
+    std::erase(dirty_leaves_, leaf);
+  }
+  RemoveLeaf(leaf);
+  FreeNode(leaf);
+  leaves_.erase(it);
+}
+
+void DynamicAabbTree::MarkDirty(const Collider* collider) {
+  assert(collider);
+  auto it = leaves_.find(collider);
+  if (it == leaves_.end() || nodes_[it->second].is_dirty) {
+    return;
+  }
+
+  nodes_[it->second].is_dirty = true;
+  dirty_leaves_.push_back(it->second);
+}
+
+void DynamicAabbTree::UpdateCategory(const Collider* collider) {
+  assert(collider);
+  auto it = leaves_.find(collider);
+  if (it == leaves_.end()) {
+    return;
+  }
+
+  int32_t leaf = it->second;
+  nodes_[leaf].categories = collider->GetCollisionCategory();
+  // Categories cannot be subtracted from a union, so rebuild the unions of the
+  // branches above from their children.
+  for (int32_t node = nodes_[leaf].parent; node != kNullNode;
+       node = nodes_[node].parent) {
+    TreeNode& branch = nodes_[node];
+    branch.categories = nodes_[branch.left].categories |
+                        nodes_[branch.right].categories;
+  }
+}
+
+void DynamicAabbTree::Refresh() {
+  for (int32_t leaf : dirty_leaves_) {
+    TreeNode& node = nodes_[leaf];
+    node.is_dirty = false;
+
+    // Most moves stay within the fattened bounds, leaving the tree untouched.
+    sf::FloatRect bounds = node.collider->GetGlobalBounds();
+    if (bounds.position.x >= node.min.x && bounds.position.y >= node.min.y &&
+        bounds.position.x + bounds.size.x <= node.max.x &&
+        bounds.position.y + bounds.size.y <= node.max.y) {
+      continue;
+    }
+
+    RemoveLeaf(leaf);
+    FattenLeaf(leaf);
+    InsertLeaf(leaf);
+  }
+
+  dirty_leaves_.clear();
+}
+
+void DynamicAabbTree::Query(sf::FloatRect bounds, CollisionLayer mask,
+                            std::vector<const Collider*>& out) const {
+  if (root_ == kNullNode) {
+    return;
+  }
+
+  sf::Vector2f min = bounds.position;
+  sf::Vector2f max = bounds.position + bounds.size;
+  // Touching boxes overlap, as in the collider tests.
+  auto is_reached = [&](const TreeNode& node) -> bool {
+    return Intersects(node.categories, mask) && node.min.x <= max.x &&
+           node.max.x >= min.x && node.min.y <= max.y && node.max.y >= min.y;
+  };
+  if (!is_reached(nodes_[root_])) {
+    return;
+  }
+
+  // Only the nodes reached by the query are stacked, so each node is tested
+  // right after its sibling, while their parent is still in cache.
+  stack_.clear();
+  stack_.push_back(root_);
+  while (!stack_.empty()) {
+    const TreeNode& node = nodes_[stack_.back()];
+    stack_.pop_back();
+    if (node.IsLeaf()) {
+      out.push_back(node.collider);
+      continue;
+    }
+
+    for (int32_t child : {node.left, node.right}) {
+      if (is_reached(nodes_[child])) {
+        stack_.push_back(child);
+      }
+    }
+  }
+}
+
+int32_t DynamicAabbTree::GetHeight() const {
+  return root_ == kNullNode ? -1 : nodes_[root_].height;
+}
+
+int32_t DynamicAabbTree::AllocateNode() {
+  if (free_list_ == kNullNode) {
+    nodes_.emplace_back();
+    return static_cast<int32_t>(nodes_.size() - 1);
+  }
+
+  int32_t node = free_list_;
+  free_list_ = nodes_[node].parent;
+  nodes_[node] = TreeNode{};
+  return node;
+}
+
+void DynamicAabbTree::FreeNode(int32_t node) {
+  nodes_[node] = TreeNode{};
+  nodes_[node].parent = free_list_;
+  free_list_ = node;
+}
+
+void DynamicAabbTree::FattenLeaf(int32_t leaf) {
+  TreeNode& node = nodes_[leaf];
+  sf::FloatRect bounds = node.collider->GetGlobalBounds();
+  node.min = bounds.position - sf::Vector2f(margin_, margin_);
+  node.max = bounds.position + bounds.size + sf::Vector2f(margin_, margin_);
+}
+
+void DynamicAabbTree::InsertLeaf(int32_t leaf) {
+  if (root_ == kNullNode) {
+    root_ = leaf;
+    nodes_[leaf].parent = kNullNode;
+    return;
+  }
+
+  // Descends towards the sibling that minimizes the growth of the perimeters
+  // of the branches, as in the surface area heuristic.
+  sf::Vector2f leaf_min = nodes_[leaf].min;
+  sf::Vector2f leaf_max = nodes_[leaf].max;
+  int32_t sibling = root_;
+  while (!nodes_[sibling].IsLeaf()) {
+    const TreeNode& node = nodes_[sibling];
+    float perimeter = Perimeter(node.min, node.max);
+    float combined_perimeter = Perimeter(UnionMin(node.min, leaf_min),
+                                         UnionMax(node.max, leaf_max));
+    // The cost of pairing the leaf with this branch, and the growth of this
+    // branch that descending further costs anyway.
+    float cost = 2.F * combined_perimeter;
+    float inherited_cost = 2.F * (combined_perimeter - perimeter);
+
+    auto child_cost = [&](int32_t child) -> float {
+      const TreeNode& child_node = nodes_[child];
+      float child_perimeter =
+          Perimeter(UnionMin(child_node.min, leaf_min),
+                    UnionMax(child_node.max, leaf_max));
+      if (!child_node.IsLeaf()) {
+        child_perimeter -= Perimeter(child_node.min, child_node.max);
+      }
+      return child_perimeter + inherited_cost;
+    };
+    float left_cost = child_cost(node.left);
+    float right_cost = child_cost(node.right);
+    if (cost < left_cost && cost < right_cost) {
+      break;
+    }
+
+    sibling = left_cost < right_cost ? node.left : node.right;
+  }
+
+  // A new branch takes the place of the sibling, with the sibling and the
+  // leaf as children.
+  int32_t old_parent = nodes_[sibling].parent;
+  int32_t new_parent = AllocateNode();
+  TreeNode& branch = nodes_[new_parent];
+  branch.parent = old_parent;
+  branch.left = sibling;
+  branch.right = leaf;
+  nodes_[sibling].parent = new_parent;
+  nodes_[leaf].parent = new_parent;
+  if (old_parent == kNullNode) {
+    root_ = new_parent;
+  } else if (nodes_[old_parent].left == sibling) {
+    nodes_[old_parent].left = new_parent;
+  } else {
+    nodes_[old_parent].right = new_parent;
+  }
+
+  Refit(new_parent);
+}
+
+void DynamicAabbTree::RemoveLeaf(int32_t leaf) {
+  if (leaf == root_) {
+    root_ = kNullNode;
+    return;
+  }
+
+  // The sibling of the leaf takes the place of their parent.
+  int32_t parent = nodes_[leaf].parent;
+  int32_t grandparent = nodes_[parent].parent;
+  int32_t sibling = nodes_[parent].left == leaf ? nodes_[parent].right
+                                                : nodes_[parent].left;
+  nodes_[sibling].parent = grandparent;
+  FreeNode(parent);
+  if (grandparent == kNullNode) {
+    root_ = sibling;
+    return;
+  }
+
+  if (nodes_[grandparent].left == parent) {
+    nodes_[grandparent].left = sibling;
+  } else {
+    nodes_[grandparent].right = sibling;
+  }
+  Refit(grandparent);
+}
+
+void DynamicAabbTree::Refit(int32_t node) {
+  while (node != kNullNode) {
+    node = Balance(node);
+    UpdateBranch(node);
+    node = nodes_[node].parent;
+  }
+}
+
+int32_t DynamicAabbTree::Balance(int32_t node) {
+  const TreeNode& branch = nodes_[node];
+  if (branch.IsLeaf() || branch.height < 2) {
+    return node;
+  }
+
+  // The taller child moves up in place of the branch, which takes the
+  // shorter grandchild in exchange, as in an AVL tree rotation.
+  int32_t left = branch.left;
+  int32_t right = branch.right;
+  int32_t balance = nodes_[right].height - nodes_[left].height;
+  if (balance >= -1 && balance <= 1) {
+    return node;
+  }
+
+  bool is_right_taller = balance > 1;
+  int32_t up = is_right_taller ? right : left;
+  int32_t first = nodes_[up].left;
+  int32_t second = nodes_[up].right;
+
+  // The child moving up replaces the branch under its parent.
+  int32_t parent = branch.parent;
+  nodes_[up].left = node;
+  nodes_[up].parent = parent;
+  nodes_[node].parent = up;
+  if (parent == kNullNode) {
+    root_ = up;
+  } else if (nodes_[parent].left == node) {
+    nodes_[parent].left = up;
+  } else {
+    nodes_[parent].right = up;
+  }
+
+  // The taller grandchild stays with the child moving up.
+  int32_t kept = nodes_[first].height > nodes_[second].height ? first : second;
+  int32_t given = kept == first ? second : first;
+  nodes_[up].right = kept;
+  (is_right_taller ? nodes_[node].right : nodes_[node].left) = given;
+  nodes_[given].parent = node;
+
+  UpdateBranch(node);
+  UpdateBranch(up);
+  return up;
+}
+
+void DynamicAabbTree::UpdateBranch(int32_t node) {
+  TreeNode& branch = nodes_[node];
+  const TreeNode& left = nodes_[branch.left];
+  const TreeNode& right = nodes_[branch.right];
+  branch.min = UnionMin(left.min, right.min);
+  branch.max = UnionMax(left.max, right.max);
+  branch.categories = left.categories | right.categories;
+  branch.height = 1 + std::max(left.height, right.height);
+}
+
+}  // namespace ng
\ No newline at end of file
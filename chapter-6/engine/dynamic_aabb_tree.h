@@ -0,0 +1,134 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "broadphase.h"
+#include "collision_layer.h"
+
+namespace ng {
+
+class Collider;
+
+/// @brief A bounding volume hierarchy broadphase: a balanced binary tree whose leaves hold the bounds of the colliders, fattened by a margin.
+///        Colliders moving within their fattened bounds leave the tree untouched. The tree adapts to the layout of the colliders, so it has no cell size to tune.
+class DynamicAabbTree : public Broadphase {
+ public:
+  /// @brief Constructs an empty DynamicAabbTree.
+  /// @param margin How far the bounds stored in the leaves extend past those of their colliders on each side, in world units. Must not be negative.
+  explicit DynamicAabbTree(float margin);
+
+  /// @brief Inserts a collider into the tree using its current global bounds and collision category.
+  /// @param collider A pointer to the Collider to insert. This pointer must not be null and the Collider must not be already inserted.
+  void Insert(const Collider* collider) override;
+
+  /// @brief Removes a collider from the tree. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider to remove. This pointer must not be null.
+  void Remove(const Collider* collider) override;
+
+  /// @brief Marks the bounds of a collider as stale. Its leaf is checked by the next call to Refresh. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider whose global transform changed. This pointer must not be null.
+  void MarkDirty(const Collider* collider) override;
+
+  /// @brief Updates the collision category a collider is indexed by, and the categories of the branches above it. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider whose category changed. This pointer must not be null.
+  void UpdateCategory(const Collider* collider) override;
+
+  /// @brief Reinserts every collider marked dirty since the last refresh whose bounds left its fattened bounds.
+  void Refresh() override;
+
+  /// @brief Appends to `out` every collider whose fattened bounds overlap the given bounds and whose category shares a layer with the mask.
+  ///        Branches without any collider of the mask are skipped as a whole.
+  ///        Refresh must be called beforehand for the results to reflect the latest transforms.
+  /// @param bounds The world space bounds to query.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the candidate colliders are appended to.
+  void Query(sf::FloatRect bounds, CollisionLayer mask,
+             std::vector<const Collider*>& out) const override;
+
+  /// @brief Returns the height of the tree, as a measure of its balance.
+  /// @return The number of branches on the longest path from the root to a leaf, or -1 if the tree is empty.
+  [[nodiscard]] int32_t GetHeight() const;
+
+ private:
+  // The index standing for no node.
+  static constexpr int32_t kNullNode = -1;
+
+  /// @brief A node of the tree, either a leaf holding a collider or a branch with two children.
+  ///        The members read by the queries come first, and the node fits in 48 bytes.
+  struct TreeNode {
+    // The top left corner of the fattened bounds of a leaf, or of the union of the bounds of the children of a branch.
+    sf::Vector2f min;
+    // The bottom right corner of the bounds.
+    sf::Vector2f max;
+    // The category of the collider of a leaf, or the union of the categories of the leaves below a branch.
+    CollisionLayer categories = CollisionLayer::kNone;
+    // The first child of a branch, kNullNode for leaves.
+    int32_t left = kNullNode;
+    // The second child of a branch, kNullNode for leaves.
+    int32_t right = kNullNode;
+    // The parent of the node, or the next free node for nodes in the free list.
+    int32_t parent = kNullNode;
+    // The height of the subtree rooted at the node, 0 for leaves and -1 for free nodes.
+    int32_t height = -1;
+    // Flag indicating if a leaf is waiting in the dirty list.
+    bool is_dirty = false;
+    // The collider of a leaf, null for branches.
+    const Collider* collider = nullptr;
+
+    [[nodiscard]] bool IsLeaf() const { return left == kNullNode; }
+  };
+
+  /// @brief Takes a node from the free list, growing the node pool if it is empty.
+  /// @return The index of the node.
+  [[nodiscard]] int32_t AllocateNode();
+
+  /// @brief Returns a node to the free list.
+  /// @param node The index of the node.
+  void FreeNode(int32_t node);
+
+  /// @brief Sets the bounds of a leaf to the bounds of its collider fattened by the margin.
+  /// @param leaf The index of the leaf.
+  void FattenLeaf(int32_t leaf);
+
+  /// @brief Links a leaf into the tree, next to the node whose bounds grow the least by including it.
+  /// @param leaf The index of the leaf, whose bounds are set.
+  void InsertLeaf(int32_t leaf);
+
+  /// @brief Unlinks a leaf from the tree, replacing its parent by its sibling. The leaf itself is not freed.
+  /// @param leaf The index of the leaf.
+  void RemoveLeaf(int32_t leaf);
+
+  /// @brief Recomputes the bounds, categories and heights of the branches from a node up to the root, rebalancing them on the way.
+  /// @param node The index of the first branch to update.
+  void Refit(int32_t node);
+
+  /// @brief Rotates a branch if the heights of its children differ by more than one.
+  /// @param node The index of the branch.
+  /// @return The index of the node now at the place of the branch.
+  [[nodiscard]] int32_t Balance(int32_t node);
+
+  /// @brief Recomputes the bounds, categories and height of a branch from its children.
+  /// @param node The index of the branch.
+  void UpdateBranch(int32_t node);
+
+  // The margin added to the bounds of the leaves on each side.
+  float margin_ = 0;
+  // The pool of nodes, linked by index. Free nodes are chained through their parent.
+  std::vector<TreeNode> nodes_;
+  // The root of the tree, or kNullNode if the tree is empty.
+  int32_t root_ = kNullNode;
+  // The first node of the free list, or kNullNode if every node is in use.
+  int32_t free_list_ = kNullNode;
+  // The leaves of all the inserted colliders.
+  std::unordered_map<const Collider*, int32_t> leaves_;
+  // The leaves whose bounds have to be checked.
+  std::vector<int32_t> dirty_leaves_;
+  // The branches left to visit by the current query. Kept to reuse its memory.
+  mutable std::vector<int32_t> stack_;
+};
+
+}  // namespace ng
\ No newline at end of file
@@ -1,30 +1,57 @@
 #include "node.h"
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Transform.hpp>
 #include <SFML/Graphics/Transformable.hpp>
 #include <SFML/System/Angle.hpp>
 #include <SFML/System/Vector2.hpp>
-#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
-#include <cstdint>
-#include <functional>
 #include <memory>
+#include <new>
+#include <optional>
 #include <span>
 #include <string>
 #include <utility>
 
 #include "layer.h"
+#include "node_arena.h"
+#include "node_handle.h"
 #include "scene.h"
+#include "type_id.h"
 
 namespace ng {
 
-Node::Node(App* app) : app_(app) {
+Node::Node(App* app) : app_(app), arena_(NodeArena::GetCurrent()) {
   assert(app);
 }
 
+void* Node::operator new(size_t size) {
+  NodeArena* arena = NodeArena::GetCurrent();
+  size_t block_size = kArenaHeaderSize + size;
+  void* block = arena != nullptr ? arena->Allocate(block_size)
+                                 : ::operator new(block_size);
+  std::construct_at(static_cast<NodeArena**>(block), arena);
+  return static_cast<std::byte*>(block) + kArenaHeaderSize;
+}
+
+void Node::operator delete(void* ptr, size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+
+  void* block = static_cast<std::byte*>(ptr) - kArenaHeaderSize;
+  NodeArena* arena = *static_cast<NodeArena**>(block);
+  size_t block_size = kArenaHeaderSize + size;
+  if (arena != nullptr) {
+    arena->Deallocate(block, block_size);
+  } else {
+    ::operator delete(block, block_size);
+  }
+}
+
 const std::string& Node::GetName() const {
   return name_;
 }
@@ -41,6 +68,10 @@ Scene* Node::GetScene() const {
   return scene_;
 }
 
+NodeHandle Node::GetHandle() const {
+  return handle_;
+}
+
 Node* Node::GetParent() const {
   return parent_;
 }
@@ -51,21 +82,59 @@ Layer Node::GetLayer() const {
 
 void Node::SetLayer(Layer layer) {
   layer_ = layer;
+  if (scene_ != nullptr) {
+    scene_->InvalidateDrawList();
+  }
+}
+
+bool Node::IsDrawnDirectly() const {
+  return is_drawn_directly_;
+}
+
+void Node::SetDrawnDirectly(bool is_drawn_directly) {
+  is_drawn_directly_ = is_drawn_directly;
+}
+
+bool Node::IsTickEnabled() const {
+  return is_tick_enabled_;
+}
+
+void Node::SetTickEnabled(bool is_tick_enabled) {
+  if (is_tick_enabled_ == is_tick_enabled) {
+    return;
+  }
+
+  is_tick_enabled_ = is_tick_enabled;
+  // Nodes not added yet, or already removed, are registered by InternalOnAdd.
+  if (scene_ == nullptr || !scene_->IsValid(handle_)) {
+    return;
+  }
+
+  if (is_tick_enabled_) {
+    scene_->RegisterTick(this);
+  } else {
+    scene_->UnregisterTick(this);
+  }
 }
 
-void Node::AddChild(std::unique_ptr<Node> new_child) {
+void Node::InternalAddChild(std::unique_ptr<Node> new_child) {
   new_child->parent_ = this;
   new_child->DirtyGlobalTransform();
   children_to_add_.push_back(std::move(new_child));
+  QueueStructureChanges();
 }
 
 void Node::DestroyChild(const Node& child_to_destroy) {
-  for (size_t i = 0; i < children_.size(); ++i) {
-    if (children_[i].get() == &child_to_destroy) {
-      children_to_erase_.push_back(i);
-      break;
-    }
+  assert(child_to_destroy.parent_ == this);
+  if (child_to_destroy.is_destruction_scheduled_ ||
+      child_to_destroy.child_index_ == kInvalidChildIndex) {
+    return;
   }
+
+  assert(children_[child_to_destroy.child_index_].get() == &child_to_destroy);
+  children_[child_to_destroy.child_index_]->is_destruction_scheduled_ = true;
+  children_to_erase_.push_back(child_to_destroy.child_index_);
+  QueueStructureChanges();
 }
 
 void Node::Destroy() {
@@ -79,29 +148,18 @@ const sf::Transformable& Node::GetLocalTransform() const {
 }
 
 const sf::Transformable& Node::GetGlobalTransform() const {
+  // Also refreshes the dirty flag of the decomposition.
+  const sf::Transform& global_matrix = GetGlobalMatrix();
+
   if (is_global_transform_dirty_) {
     if (parent_ != nullptr) {
-      sf::Transform new_transform =
-          parent_->GetGlobalTransform().getTransform() *
-          GetLocalTransform().getTransform();
-
-      auto matrix = std::span(new_transform.getMatrix(), 16);
-
+      auto matrix = std::span(global_matrix.getMatrix(), 16);
       float a00 = matrix[0];
       float a01 = matrix[4];
-      float a02 = matrix[12];
-      float a10 = matrix[1];
-      float a11 = matrix[5];
-      float a12 = matrix[13];
-
-      sf::Angle rotation(sf::radians(std::atan2(-a01, a00)));
-      sf::Vector2 scale(std::sqrt((a00 * a00) + (a10 * a10)),
-                        std::sqrt((a01 * a01) + (a11 * a11)));
-      sf::Vector2f position(a02, a12);
-
-      global_transform_.setRotation(rotation);
-      global_transform_.setScale(scale);
-      global_transform_.setPosition(position);
+
+      global_transform_.setRotation(sf::radians(std::atan2(-a01, a00)));
+      global_transform_.setScale(GetGlobalScale());
+      global_transform_.setPosition(GetGlobalPosition());
     } else {
       global_transform_ = GetLocalTransform();
     }
@@ -112,6 +170,55 @@ const sf::Transformable& Node::GetGlobalTransform() const {
   return global_transform_;
 }
 
+const sf::Transform& Node::GetGlobalMatrix() const {
+  if (is_global_matrix_dirty_) {
+    if (parent_ != nullptr) {
+      global_matrix_ =
+          parent_->GetGlobalMatrix() * GetLocalTransform().getTransform();
+    } else {
+      global_matrix_ = GetLocalTransform().getTransform();
+    }
+
+    is_global_matrix_dirty_ = false;
+  }
+
+  return global_matrix_;
+}
+
+sf::Vector2f Node::GetGlobalPosition() const {
+  auto matrix = std::span(GetGlobalMatrix().getMatrix(), 16);
+  return {matrix[12], matrix[13]};
+}
+
+sf::Vector2f Node::GetGlobalScale() const {
+  auto matrix = std::span(GetGlobalMatrix().getMatrix(), 16);
+  float a00 = matrix[0];
+  float a01 = matrix[4];
+  float a10 = matrix[1];
+  float a11 = matrix[5];
+  return {std::sqrt((a00 * a00) + (a10 * a10)),
+          std::sqrt((a01 * a01) + (a11 * a11))};
+}
+
+std::optional<sf::FloatRect> Node::GetLocalBounds() const {
+  return std::nullopt;
+}
+
+const std::optional<sf::FloatRect>& Node::GetWorldBounds() const {
+  if (is_world_bounds_dirty_) {
+    std::optional<sf::FloatRect> local_bounds = GetLocalBounds();
+    if (local_bounds.has_value()) {
+      world_bounds_ = GetGlobalMatrix().transformRect(*local_bounds);
+    } else {
+      world_bounds_.reset();
+    }
+
+    is_world_bounds_dirty_ = false;
+  }
+
+  return world_bounds_;
+}
+
 void Node::SetLocalPosition(sf::Vector2f position) {
   local_transform_.setPosition(position);
   DirtyGlobalTransform();
@@ -132,6 +239,14 @@ void Node::Translate(sf::Vector2f delta) {
   DirtyGlobalTransform();
 }
 
+TypeId Node::GetTypeId() const {
+  return type_id_;
+}
+
+void Node::InvalidateLocalBounds() {
+  is_world_bounds_dirty_ = true;
+}
+
 void Node::OnAdd() {}
 
 void Node::Update() {}
@@ -140,6 +255,49 @@ void Node::Draw([[maybe_unused]] sf::RenderTarget& target) {}
 
 void Node::OnDestroy() {}
 
+void Node::OnCollisionEnter([[maybe_unused]] const Collider& collider,
+                            [[maybe_unused]] const Collider& other) {}
+
+void Node::OnCollisionStay([[maybe_unused]] const Collider& collider,
+                           [[maybe_unused]] const Collider& other) {}
+
+void Node::OnCollisionExit([[maybe_unused]] const Collider& collider,
+                           [[maybe_unused]] const Collider& other) {}
+
+void Node::OnGlobalTransformChange() {}
+
+bool Node::IsDestructionScheduled() const {
+  for (const Node* node = this; node != nullptr; node = node->parent_) {
+    if (node->is_destruction_scheduled_) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void Node::QueueStructureChanges() {
+  // Nodes outside of a scene have their queued children added along with
+  // them by AddQueuedChildren.
+  if (is_structure_change_queued_ || scene_ == nullptr) {
+    return;
+  }
+
+  is_structure_change_queued_ = true;
+  scene_->QueueStructureChanges(this);
+}
+
+void Node::ApplyStructureChanges() {
+  is_structure_change_queued_ = false;
+  // The whole subtree is removed along with the destroyed ancestor, so its
+  // queued children are never added.
+  if (IsDestructionScheduled()) {
+    return;
+  }
+
+  EraseDestroyedChildren();
+  AddQueuedChildren();
+}
+
 void Node::EraseDestroyedChildren() {
   if (children_to_erase_.empty()) {
     return;
@@ -148,11 +306,37 @@ void Node::EraseDestroyedChildren() {
   // This is required because a newly destroyed child may destroy a new child
   // from its parent (this node), invalidating the current children_to_erase_ vector.
   auto prev_frame_children_to_erase = std::move(children_to_erase_);
-  std::ranges::sort(prev_frame_children_to_erase, std::greater<>());
   for (size_t to_erase : prev_frame_children_to_erase) {
     children_[to_erase]->InternalOnDestroy();
-    children_.erase(children_.begin() + static_cast<int64_t>(to_erase));
+    children_[to_erase] = nullptr;
+    ++empty_child_slot_count_;
+  }
+
+  if (empty_child_slot_count_ * 2 >= children_.size()) {
+    CompactChildren();
+  }
+}
+
+void Node::CompactChildren() {
+  // Children scheduled for destruction by the OnDestroy of a sibling are
+  // referenced by slot index until the next frame, so the slots must not move.
+  if (!children_to_erase_.empty()) {
+    return;
+  }
+
+  size_t next_index = 0;
+  for (auto& child : children_) {
+    if (child == nullptr) {
+      continue;
+    }
+
+    child->child_index_ = next_index;
+    children_[next_index] = std::move(child);
+    ++next_index;
   }
+
+  children_.resize(next_index);
+  empty_child_slot_count_ = 0;
 }
 
 void Node::AddQueuedChildren() {
@@ -161,55 +345,51 @@ void Node::AddQueuedChildren() {
   auto prev_frame_children_to_add = std::move(children_to_add_);
   for (auto& to_add : prev_frame_children_to_add) {
     Node* tmp = to_add.get();
+    tmp->child_index_ = children_.size();
     children_.push_back(std::move(to_add));
     tmp->InternalOnAdd(scene_);
+    tmp->AddQueuedChildren();
   }
 }
 
 void Node::InternalOnAdd(Scene* scene) {
   scene_ = scene;
-  scene_->RegisterNode(this);
-  OnAdd();
-}
-
-void Node::InternalUpdate() {
-  EraseDestroyedChildren();
-  AddQueuedChildren();
-
-  Update();
-  for (auto& child : children_) {
-    child->InternalUpdate();
-  }
-}
-
-void Node::InternalDraw(const Camera& camera, sf::RenderTarget& target) {
-  if ((std::to_underlying(layer_) &
-       std::to_underlying(camera.GetRenderLayers())) == 0) {
-    return;
-  }
-
-  Draw(target);
-  for (auto& child : children_) {
-    child->InternalDraw(camera, target);
+  arena_ = &scene_->node_arena_;
+  handle_ = scene_->RegisterNode(this);
+  if (is_tick_enabled_) {
+    scene_->RegisterTick(this);
   }
+  scene_->InvalidateDrawList();
+  OnAdd();
 }
 
 void Node::InternalOnDestroy() {
-  scene_->UnregisterNode(this);
+  scene_->UnregisterNode(handle_);
+  if (tick_index_ != kInvalidTickIndex) {
+    scene_->UnregisterTick(this);
+  }
+  scene_->InvalidateDrawList();
   OnDestroy();
   for (auto& child : children_) {
-    child->InternalOnDestroy();
+    if (child != nullptr) {
+      child->InternalOnDestroy();
+    }
   }
 }
 
 void Node::DirtyGlobalTransform() {
-  if (is_global_transform_dirty_) {
+  if (is_global_matrix_dirty_) {
     return;
   }
 
+  is_global_matrix_dirty_ = true;
   is_global_transform_dirty_ = true;
+  is_world_bounds_dirty_ = true;
+  OnGlobalTransformChange();
   for (auto& child : children_) {
-    child->DirtyGlobalTransform();
+    if (child != nullptr) {
+      child->DirtyGlobalTransform();
+    }
   }
 }
 
@@ -1,30 +1,45 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Transform.hpp>
 #include <SFML/Graphics/Transformable.hpp>
 #include <SFML/System/Angle.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cassert>
 #include <cstddef>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include "derived.h"
 #include "layer.h"
+#include "node_arena.h"
+#include "node_handle.h"
+#include "type_id.h"
 
 namespace ng {
 
 class App;
-class Camera;
+class Collider;
+class Physics;
 class Scene;
 
 /// @brief The base class for all entities in the game world, forming a scene graph.
 ///        Manages local and global transformations, parent-child relationships, and rendering layers.
 class Node {
  public:
-  // Scene needs to be able to call InternalOnAdd, InternalUpdate,
-  // InternalDraw, and InternalOnDestroy.
+  // Scene needs to be able to call InternalOnAdd, ApplyStructureChanges,
+  // InternalOnDestroy, Update, and Draw, and to walk children_ when building
+  // its draw lists.
   friend class Scene;
+  // Physics needs to be able to call OnCollisionEnter, OnCollisionStay, and
+  // OnCollisionExit.
+  friend class Physics;
 
   /// @brief Constructs a Node associated with a specific App instance.
   /// @param app A pointer to the App instance this node belongs to. This pointer must not be null.
@@ -36,6 +51,16 @@ class Node {
   Node(Node&& other) = delete;
   Node& operator=(Node&& other) = delete;
 
+  /// @brief Allocates a node from the current NodeArena of the thread, or from the heap if there is none.
+  ///        The arena is recorded in front of the node, so it is returned to the right arena when deleted.
+  /// @param size The size of the node in bytes.
+  /// @return A pointer to the memory of the node.
+  static void* operator new(size_t size);
+  /// @brief Returns the memory of a node to the arena it was allocated from.
+  /// @param ptr A pointer returned by operator new. Can be null.
+  /// @param size The size of the node in bytes.
+  static void operator delete(void* ptr, size_t size);
+
   /// @brief Returns the name of the node.
   /// @return A constant reference to the node's name.
   [[nodiscard]] const std::string& GetName() const;
@@ -52,6 +77,10 @@ class Node {
   /// @return A pointer to the Scene, or null if the node is not part of a scene.
   [[nodiscard]] Scene* GetScene() const;
 
+  /// @brief Returns the handle of this node in its Scene, which remains safe to check after the node is destroyed.
+  /// @return The handle of the node. Invalid until the node is added to a scene.
+  [[nodiscard]] NodeHandle GetHandle() const;
+
   /// @brief Returns the parent node in the scene graph. Can be null if this is the root node or not yet added as a child.
   /// @return A pointer to the parent Node, or null if there is no parent.
   [[nodiscard]] Node* GetParent() const;
@@ -61,28 +90,62 @@ class Node {
   [[nodiscard]] Layer GetLayer() const;
 
   /// @brief Sets the rendering layer of this node.
+  ///        A node is drawn by the cameras rendering at least one of the layers shared by the node and all its ancestors.
   /// @param layer The new Layer for this node.
   void SetLayer(Layer layer);
 
+  /// @brief Returns whether the Draw of this node renders to the target directly, rather than only through the SpriteBatch of its scene or not at all.
+  /// @return True if the node draws directly, false otherwise.
+  [[nodiscard]] bool IsDrawnDirectly() const;
+
+  /// @brief Declares whether the Draw of this node renders to the target directly. Nodes are assumed to by default.
+  ///        The scene flushes the sprites batched so far before drawing a node drawn directly, so that the node covers the nodes drawn before it.
+  ///        Nodes drawing only through the SpriteBatch, or nothing at all, should declare it, so that the sprites around them share draw calls.
+  /// @param is_drawn_directly True if Draw renders to the target directly, false otherwise.
+  void SetDrawnDirectly(bool is_drawn_directly);
+
+  /// @brief Returns whether the Update of this node is called every tick.
+  /// @return True if the node ticks, false otherwise.
+  [[nodiscard]] bool IsTickEnabled() const;
+
+  /// @brief Enables or disables the calls to Update of this node. Nodes tick by default.
+  ///        Nodes without Update logic should disable ticking, so that the scene does not visit them at all.
+  ///        A node enabled during a tick starts ticking on the next one, after the nodes that were already ticking.
+  /// @param is_tick_enabled True to call Update every tick, false otherwise.
+  void SetTickEnabled(bool is_tick_enabled);
+
   /// @brief Adds a new child node to this node. Ownership of the child is transferred.
+  ///        The child is tagged with the TypeId of T, which is what Is and As compare against, so T must be the concrete type of the child:
+  ///        a Player passed as a std::unique_ptr<Node> would be tagged as a Node and As<Player> would return nullptr. Asserted in debug builds.
+  /// @tparam T The concrete type of the Node to add, must derive from Node.
   /// @param new_child A unique pointer to the Node to be added. This pointer must not be null.
-  void AddChild(std::unique_ptr<Node> new_child);
+  template <Derived<Node> T>
+  void AddChild(std::unique_ptr<T> new_child) {
+    assert(new_child);
+    [[maybe_unused]] const Node& child = *new_child;
+    assert(typeid(child) == typeid(T));
+    new_child->type_id_ = ng::GetTypeId<T>();
+    InternalAddChild(std::move(new_child));
+  }
 
   /// @brief Creates and adds a new child node of the specified type to this node.
+  ///        The child and the nodes it creates in its constructor are allocated from the arena of this node's Scene.
   /// @tparam T The type of the Node to create, must derive from Node.
   /// @tparam Args The constructor arguments for the Node type T.
   /// @param args The arguments to forward to the constructor of T.
   /// @return A reference to the newly created and added Node.
   template <Derived<Node> T, typename... Args>
   T& MakeChild(Args&&... args) {
+    NodeArena::Scope arena_scope(arena_);
     auto child = std::make_unique<T>(app_, std::forward<Args>(args)...);
     T& ref = *child;
     AddChild(std::move(child));
     return ref;
   }
 
-  /// @brief Schedules a child node for destruction. The actual removal happens at the beginning of the next frame.
-  /// @param child_to_destroy A constant reference to the child Node to be destroyed.
+  /// @brief Schedules a child node for destruction in constant time. The actual removal happens at the beginning of the next frame.
+  ///        Has no effect if the child is already scheduled for destruction or is still queued to be added.
+  /// @param child_to_destroy A constant reference to the child Node to be destroyed. Must be a child of this node.
   void DestroyChild(const Node& child_to_destroy);
 
   /// @brief Schedules this node for destruction. The actual removal happens at the beginning of the next frame by its parent.
@@ -92,11 +155,35 @@ class Node {
   /// @return A constant reference to the local SFML Transformable.
   [[nodiscard]] const sf::Transformable& GetLocalTransform() const;
 
-  /// @brief Returns the global transformation of this node, taking into account its parent's transformations.
-  ///        This is calculated lazily and cached until the local transform changes.
+  /// @brief Returns the global transformation of this node, decomposed into position, rotation and scale.
+  ///        The decomposition is calculated lazily from GetGlobalMatrix and cached until the global matrix changes.
+  ///        Prefer GetGlobalMatrix, GetGlobalPosition and GetGlobalScale on hot paths, which do not need any trigonometry.
   /// @return A constant reference to the global SFML Transformable.
   [[nodiscard]] const sf::Transformable& GetGlobalTransform() const;
 
+  /// @brief Returns the global affine matrix of this node, taking into account its parent's transformations.
+  ///        This is calculated lazily and cached until the local transform of the node or of an ancestor changes.
+  /// @return A constant reference to the global SFML Transform.
+  [[nodiscard]] const sf::Transform& GetGlobalMatrix() const;
+
+  /// @brief Returns the global position of this node, read from the global matrix.
+  /// @return The global position.
+  [[nodiscard]] sf::Vector2f GetGlobalPosition() const;
+
+  /// @brief Returns the global scale of this node, computed from the global matrix without trigonometry.
+  ///        Like the decomposition of GetGlobalTransform, the scale is always positive.
+  /// @return The global scale.
+  [[nodiscard]] sf::Vector2f GetGlobalScale() const;
+
+  /// @brief Returns the bounds of what the node draws, in its local space. Used by the cameras to skip nodes outside of their view.
+  /// @return The local bounds of the node, or nullopt if the node has no bounds and must always be drawn. Nodes have no bounds by default.
+  [[nodiscard]] virtual std::optional<sf::FloatRect> GetLocalBounds() const;
+
+  /// @brief Returns the axis-aligned bounds of the node in world space, transformed from GetLocalBounds by the global matrix.
+  ///        This is calculated lazily and cached until the global matrix changes or InvalidateLocalBounds is called.
+  /// @return A constant reference to the world bounds of the node, or to nullopt if the node has no bounds.
+  [[nodiscard]] const std::optional<sf::FloatRect>& GetWorldBounds() const;
+
   /// @brief Sets the local position of the node.
   /// @param position The new local position.
   void SetLocalPosition(sf::Vector2f position);
@@ -113,12 +200,46 @@ class Node {
   /// @param delta The translation vector.
   void Translate(sf::Vector2f delta);
 
+  /// @brief Returns the TypeId of the type this node was created as through MakeChild or AddChild.
+  /// @return The TypeId of the node.
+  [[nodiscard]] TypeId GetTypeId() const;
+
+  /// @brief Checks if this node was created as a specific type, with a single integer compare and without RTTI.
+  ///        Only the exact type matches: a node created as a type derived from T is not a T.
+  /// @tparam T The type to check, must derive from Node.
+  /// @return True if the node was created as T, false otherwise.
+  template <Derived<Node> T>
+  [[nodiscard]] bool Is() const {
+    return type_id_ == ng::GetTypeId<T>();
+  }
+
+  /// @brief Casts this node to a specific type if it was created as exactly that type, without RTTI.
+  /// @tparam T The type to cast to, must derive from Node.
+  /// @return A pointer to this node as a T, or nullptr if the node was not created as T.
+  template <Derived<Node> T>
+  [[nodiscard]] T* As() {
+    return Is<T>() ? static_cast<T*>(this) : nullptr;
+  }
+
+  /// @brief Casts this node to a specific type if it was created as exactly that type, without RTTI.
+  /// @tparam T The type to cast to, must derive from Node.
+  /// @return A constant pointer to this node as a T, or nullptr if the node was not created as T.
+  template <Derived<Node> T>
+  [[nodiscard]] const T* As() const {
+    return Is<T>() ? static_cast<const T*>(this) : nullptr;
+  }
+
   /// @brief Returns the first child node of a specific type.
   /// @tparam T The type of the child Node to retrieve, must derive from Node.
   /// @return A pointer to the first child of type T, or nullptr if no such child exists.
   template <Derived<Node> T>
   [[nodiscard]] T* GetChild() {
     for (const auto& child : children_) {
+      // Destroyed children leave an empty slot until the next compaction.
+      if (child == nullptr) {
+        continue;
+      }
+
       T* c = dynamic_cast<T*>(child.get());
       if (c != nullptr) {
         return c;
@@ -128,62 +249,130 @@ class Node {
   }
 
  protected:
+  /// @brief Invalidates the cached world bounds. Must be called by nodes whose GetLocalBounds changes without a change of transform.
+  void InvalidateLocalBounds();
+
   /// @brief Called when the node is added to a scene graph.
   virtual void OnAdd();
-  /// @brief Called during the update phase of the game loop.
+  /// @brief Called during the update phase of the game loop, if ticking is enabled.
   virtual void Update();
-  /// @brief Called during the draw phase of the game loop.
+  /// @brief Called during the draw phase of the game loop, once per camera rendering the layers of the node.
   /// @param target The SFML RenderTarget to draw to.
   virtual void Draw(sf::RenderTarget& target);
   /// @brief Called when the node is about to be destroyed or removed from the scene graph.
   virtual void OnDestroy();
+  /// @brief Called after the update phase when a child collider of this node starts overlapping another collider.
+  /// @param collider The child collider of this node.
+  /// @param other The collider it overlaps.
+  virtual void OnCollisionEnter(const Collider& collider, const Collider& other);
+  /// @brief Called after the update phase on every following tick during which a child collider of this node keeps overlapping another collider.
+  /// @param collider The child collider of this node.
+  /// @param other The collider it overlaps.
+  virtual void OnCollisionStay(const Collider& collider, const Collider& other);
+  /// @brief Called when a child collider of this node stops overlapping another collider, either after the update phase or when one of them is removed from the scene.
+  /// @param collider The child collider of this node.
+  /// @param other The collider it no longer overlaps. Still alive during the call when it is being removed.
+  virtual void OnCollisionExit(const Collider& collider, const Collider& other);
+  /// @brief Called when the cached global transform is invalidated, either by a local change or by a change of an ancestor.
+  ///        Not called again until the global matrix has been recalculated.
+  virtual void OnGlobalTransformChange();
 
  private:
-  /// @brief Removes children that were scheduled for destruction in the previous frame.
+  // The space reserved in front of each node for the arena it was allocated from, preserving the alignment of the node.
+  static constexpr size_t kArenaHeaderSize = NodeArena::kAlignment;
+
+  // The child index of a node that is not in the children of its parent yet.
+  static constexpr size_t kInvalidChildIndex = std::numeric_limits<size_t>::max();
+  // The tick index of a node that is not in the tick list of its scene.
+  static constexpr size_t kInvalidTickIndex = std::numeric_limits<size_t>::max();
+
+  /// @brief Queues a child to be added at the beginning of the next frame.
+  /// @param new_child A unique pointer to the Node to be added. This pointer must not be null.
+  void InternalAddChild(std::unique_ptr<Node> new_child);
+
+  /// @brief Checks if this node or one of its ancestors is scheduled for destruction.
+  /// @return True if the node is going to be removed at the beginning of the next frame.
+  [[nodiscard]] bool IsDestructionScheduled() const;
+
+  /// @brief Schedules the children of this node to be erased and added by the scene at the beginning of the next frame. No-op if not in a scene yet.
+  void QueueStructureChanges();
+  /// @brief Erases the children scheduled for destruction and adds the queued children, unless this node is about to be destroyed.
+  void ApplyStructureChanges();
+
+  /// @brief Removes children that were scheduled for destruction in the previous frame, leaving their slot empty.
+  ///        The slots are compacted once at least half of them are empty, so that removals cost amortized constant time.
   void EraseDestroyedChildren();
-  /// @brief Adds children that were queued to be added in the previous frame.
+  /// @brief Removes the empty slots of children_, preserving the order of the remaining children and updating their indices.
+  void CompactChildren();
+  /// @brief Adds children that were queued to be added in the previous frame, along with the children they queued before being added.
   void AddQueuedChildren();
 
   /// @brief Internal method called when the node is added to a scene. Notifies the node and its children.
   /// @param scene A pointer to the Scene this node is being added to. This pointer must not be null.
   void InternalOnAdd(Scene* scene);
-  /// @brief Internal method called during the update phase. Updates the node and its children.
-  void InternalUpdate();
-  /// @brief Internal method called during the draw phase. Draws the node and its children if they belong to the camera's render layers.
-  /// @param camera The Camera used for rendering.
-  /// @param target The SFML RenderTarget to draw to.
-  void InternalDraw(const Camera& camera, sf::RenderTarget& target);
   /// @brief Internal method called when the node is about to be destroyed. Notifies the node and its children.
   void InternalOnDestroy();
 
-  /// @brief Marks the global transform as dirty, forcing a recalculation on the next GetGlobalTransform call and propagating the dirty flag to children.
+  /// @brief Marks the global matrix as dirty, forcing a recalculation on the next GetGlobalMatrix call and propagating the dirty flag to children.
   void DirtyGlobalTransform();
 
   // The name of the node.
   std::string name_;
   // The local transformation of the node.
   sf::Transformable local_transform_;
-  // The cached global transformation of the node. Mutable for lazy evaluation.
+  // The cached global matrix of the node. Mutable for lazy evaluation.
+  mutable sf::Transform global_matrix_;
+  // Flag indicating if the global matrix needs to be recalculated. Mutable for lazy evaluation.
+  mutable bool is_global_matrix_dirty_ = false;
+  // The cached decomposition of the global matrix. Mutable for lazy evaluation.
   mutable sf::Transformable global_transform_;
-  // Flag indicating if the global transform needs to be recalculated. Mutable for lazy evaluation.
+  // Flag indicating if the global matrix needs to be decomposed again. Mutable for lazy evaluation.
   mutable bool is_global_transform_dirty_ = false;
+  // The cached world bounds of the node. Mutable for lazy evaluation.
+  mutable std::optional<sf::FloatRect> world_bounds_;
+  // Flag indicating if the world bounds need to be recalculated. Mutable for lazy evaluation.
+  mutable bool is_world_bounds_dirty_ = true;
 
   // Pointer to the App instance. Never null after construction.
   App* app_ = nullptr;
 
+  // The arena children are allocated from: the arena of scene_ once added, the current arena at construction before. Can be null.
+  NodeArena* arena_ = nullptr;
+
   // Pointer to the parent node in the scene graph. Can be null for the root.
   Node* parent_ = nullptr;
   // Pointer to the Scene this node belongs to. Can be null if not yet added to a scene.
   Scene* scene_ = nullptr;
-
-  // Vector of child nodes. Ownership is managed by this node.
+  // The handle of this node in scene_. Invalid if not yet added to a scene.
+  NodeHandle handle_;
+
+  // The index of the slot of this node in the children of its parent. kInvalidChildIndex until the node is added to its parent.
+  size_t child_index_ = kInvalidChildIndex;
+  // Flag indicating if the node is scheduled to be erased by its parent.
+  bool is_destruction_scheduled_ = false;
+  // Flag indicating if the node is waiting for the scene to apply its structure changes.
+  bool is_structure_change_queued_ = false;
+
+  // Flag indicating if Update is called every tick.
+  bool is_tick_enabled_ = true;
+  // The index of the node in the tick list of scene_. kInvalidTickIndex if the node does not tick or is not in a scene.
+  size_t tick_index_ = kInvalidTickIndex;
+
+  // Vector of child nodes, in order of addition. Ownership is managed by this node.
+  // The slots of destroyed children are null until the next compaction.
   std::vector<std::unique_ptr<Node>> children_;
-  // Indices of children to be erased in the next update cycle.
+  // The number of null slots in children_.
+  size_t empty_child_slot_count_ = 0;
+  // Indices of children to be erased in the next update cycle, in order of scheduling.
   std::vector<size_t> children_to_erase_;
   // Vector of children to be added in the next update cycle.
   std::vector<std::unique_ptr<Node>> children_to_add_;
   // The rendering layer of this node.
   Layer layer_ = Layer::kDefault;
+  // Flag indicating if Draw renders to the target directly rather than through the sprite batch.
+  bool is_drawn_directly_ = true;
+  // The TypeId of the type this node was created as.
+  TypeId type_id_ = ng::GetTypeId<Node>();
 };
 
 }  // namespace ng
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include "node_arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace ng {
+
+namespace {
+
+// The arena of the innermost active NodeArena::Scope of each thread.
+thread_local NodeArena* current_arena = nullptr;
+
+}  // namespace
+
+NodeArena::Scope::Scope(NodeArena* arena) : previous_(current_arena) {
+  current_arena = arena;
+}
+
+NodeArena::Scope::~Scope() {
+  current_arena = previous_;
+}
+
+NodeArena::~NodeArena() {
+  // A live block would dangle once the chunks are released, which happens
+  // when a node outlives the scene that allocated it.
+  assert(live_block_count_ == 0);
+}
+
+NodeArena* NodeArena::GetCurrent() {
+  return current_arena;
+}
+
+void* NodeArena::Allocate(size_t size) {
+  ++live_block_count_;
+  if (size > kMaxBlockSize) {
+    return ::operator new(size);
+  }
+
+  size_t size_class = GetSizeClass(size);
+  if (free_lists_[size_class] == nullptr) {
+    RefillSizeClass(size_class);
+  }
+
+  FreeBlock* block = free_lists_[size_class];
+  free_lists_[size_class] = block->next;
+  std::destroy_at(block);
+  return block;
+}
+
+void NodeArena::Deallocate(void* block, size_t size) {
+  assert(live_block_count_ > 0);
+  --live_block_count_;
+  if (size > kMaxBlockSize) {
+    ::operator delete(block, size);
+    return;
+  }
+
+  size_t size_class = GetSizeClass(size);
+  free_lists_[size_class] =
+      std::construct_at(static_cast<FreeBlock*>(block),
+                        FreeBlock{.next = free_lists_[size_class]});
+}
+
+size_t NodeArena::GetChunkCount() const {
+  return chunks_.size();
+}
+
+size_t NodeArena::GetLiveBlockCount() const {
+  return live_block_count_;
+}
+
+size_t NodeArena::GetSizeClass(size_t size) {
+  assert(size <= kMaxBlockSize);
+  return (std::max(size, size_t{1}) - 1) / kAlignment;
+}
+
+void NodeArena::RefillSizeClass(size_t size_class) {
+  size_t block_size = (size_class + 1) * kAlignment;
+  size_t block_count = std::max(kChunkSize / block_size, size_t{1});
+
+  // Array new aligns to the default new alignment, which covers kAlignment.
+  static_assert(__STDCPP_DEFAULT_NEW_ALIGNMENT__ >= kAlignment);
+  auto& chunk = chunks_.emplace_back(
+      std::make_unique_for_overwrite<std::byte[]>(block_size * block_count));
+
+  // Links the blocks in address order, so consecutive allocations are
+  // contiguous in memory.
+  FreeBlock* next = free_lists_[size_class];
+  for (size_t i = block_count; i > 0; --i) {
+    next = std::construct_at(
+        reinterpret_cast<FreeBlock*>(&chunk[(i - 1) * block_size]),
+        FreeBlock{.next = next});
+  }
+  free_lists_[size_class] = next;
+}
+
+}  // namespace ng
\ No newline at end of file
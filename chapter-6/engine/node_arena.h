@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace ng {
+
+/// @brief A size-class pool allocator backing the Nodes of a Scene.
+///        Blocks are carved from large chunks, so nodes of the same size are packed next to each other, and freed blocks are recycled without going back to the heap.
+///        All the chunks are released at once when the arena is destroyed. Not thread-safe.
+class NodeArena {
+ public:
+  /// @brief Makes an arena the current arena of the calling thread for the lifetime of the scope, restoring the previous one on exit.
+  ///        Nodes allocated with `new` while a scope is active are allocated from its arena.
+  class Scope {
+   public:
+    /// @brief Makes an arena current.
+    /// @param arena A pointer to the arena to make current. Can be null to allocate from the heap.
+    explicit Scope(NodeArena* arena);
+    ~Scope();
+
+    Scope(const Scope& other) = delete;
+    Scope& operator=(const Scope& other) = delete;
+    Scope(Scope&& other) = delete;
+    Scope& operator=(Scope&& other) = delete;
+
+   private:
+    // The arena that was current when the scope was entered. Can be null.
+    NodeArena* previous_ = nullptr;
+  };
+
+  /// @brief The alignment of every block returned by the arena.
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+  /// @brief The largest block size served from the pools. Larger allocations are forwarded to the heap.
+  static constexpr size_t kMaxBlockSize = 4096;
+
+  NodeArena() = default;
+  /// @brief Releases all the chunks of the arena. Every block must have been deallocated.
+  ~NodeArena();
+
+  NodeArena(const NodeArena& other) = delete;
+  NodeArena& operator=(const NodeArena& other) = delete;
+  NodeArena(NodeArena&& other) = delete;
+  NodeArena& operator=(NodeArena&& other) = delete;
+
+  /// @brief Returns the current arena of the calling thread.
+  /// @return A pointer to the arena of the innermost active Scope, or null if there is none.
+  [[nodiscard]] static NodeArena* GetCurrent();
+
+  /// @brief Allocates a block of memory aligned to kAlignment.
+  /// @param size The size of the block in bytes.
+  /// @return A pointer to the block. Never null.
+  [[nodiscard]] void* Allocate(size_t size);
+
+  /// @brief Returns a block to the pool of its size class.
+  /// @param block A pointer to a block returned by Allocate of this arena.
+  /// @param size The size that was passed to Allocate.
+  void Deallocate(void* block, size_t size);
+
+  /// @brief Returns the number of chunks allocated from the heap by the arena.
+  /// @return The number of chunks.
+  [[nodiscard]] size_t GetChunkCount() const;
+
+  /// @brief Returns the number of blocks currently allocated from the arena, including those forwarded to the heap.
+  /// @return The number of live blocks.
+  [[nodiscard]] size_t GetLiveBlockCount() const;
+
+ private:
+  // The size of the chunks blocks are carved from, unless a single block is larger.
+  static constexpr size_t kChunkSize = size_t{64} * 1024;
+  // The number of size classes, one every kAlignment bytes up to kMaxBlockSize.
+  static constexpr size_t kSizeClassCount = kMaxBlockSize / kAlignment;
+
+  /// @brief A free block, linked to the next free block of the same size class.
+  struct FreeBlock {
+    FreeBlock* next = nullptr;
+  };
+
+  /// @brief Returns the size class of a block size.
+  /// @param size The size of the block in bytes. Must be at most kMaxBlockSize.
+  /// @return The index of the size class in free_lists_.
+  static size_t GetSizeClass(size_t size);
+
+  /// @brief Allocates a new chunk and splits it into free blocks of a size class.
+  /// @param size_class The index of the size class to refill.
+  void RefillSizeClass(size_t size_class);
+
+  // The head of the free list of each size class. Null if the class has no free block.
+  std::array<FreeBlock*, kSizeClassCount> free_lists_{};
+  // The chunks allocated from the heap, released when the arena is destroyed.
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  // The number of blocks currently allocated.
+  size_t live_block_count_ = 0;
+};
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace ng {
+
+/// @brief A weak reference to a Node registered in a Scene, made of the identifier of the scene, a slot index and the generation of that slot.
+///        The slot generation changes when its node is removed, so a handle never refers to a node created later in the same slot.
+///        The scene identifier makes a handle invalid in every other scene. Default-constructed handles are always invalid.
+struct NodeHandle {
+  /// @brief The index of an unused slot, never allocated by a scene.
+  static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+  /// @brief The identifier of the scene that issued the handle. Scenes are numbered from 1, so 0 matches no scene.
+  uint32_t scene_id = 0;
+  /// @brief The index of the node slot in the scene.
+  uint32_t index = kInvalidIndex;
+  /// @brief The generation of the slot when the node was registered.
+  uint32_t generation = 0;
+
+  bool operator==(const NodeHandle& other) const = default;
+};
+
+}  // namespace ng
\ No newline at end of file
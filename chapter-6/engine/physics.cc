@@ -1,36 +1,456 @@
 #include "physics.h"
 
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
 #include <cassert>
-#include <unordered_set>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
 #include "collider.h"
+#include "collider_store.h"
+#include "collision_layer.h"
+#include "dynamic_aabb_tree.h"
+#include "profiler.h"
+#include "spatial_hash.h"
+#include "sweep.h"
 
 namespace ng {
 
+// Roughly the size of a character, so that most colliders span few cells.
+static constexpr float kCellSize = 64.F;
+// Enough for a character to walk for a few ticks before its leaf has to be
+// moved in the tree.
+static constexpr float kTreeMargin = 8.F;
+// The largest half size of the squares queried by QueryNearest, finite so
+// that the corners of the squares stay finite.
+static constexpr float kMaxNearestHalfSize =
+    std::numeric_limits<float>::max() / 4.F;
+
+Physics::Physics(PhysicsBroadphase broadphase)
+    : broadphase_kind_(broadphase) {
+  switch (broadphase) {
+    case PhysicsBroadphase::kScan:
+      break;
+    case PhysicsBroadphase::kSpatialHash:
+      broadphase_ = std::make_unique<SpatialHash>(kCellSize);
+      break;
+    case PhysicsBroadphase::kDynamicTree:
+      broadphase_ = std::make_unique<DynamicAabbTree>(kTreeMargin);
+      break;
+  }
+}
+
+PhysicsBroadphase Physics::GetBroadphase() const {
+  return broadphase_kind_;
+}
+
 std::vector<const Collider*> Physics::Overlap(const Collider& collider) const {
   std::vector<const Collider*> collisions;
-  for (const auto* other : colliders_) {
-    if (other == &collider) {
+  Overlap(collider, collisions);
+  return collisions;
+}
+
+void Physics::Overlap(const Collider& collider,
+                      std::vector<const Collider*>& out) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::Overlap");
+
+  CollectOverlaps(collider);
+  for (size_t index : overlaps_) {
+    out.push_back(colliders_[index]);
+  }
+}
+
+size_t Physics::Overlap(const Collider& collider,
+                        std::span<const Collider*> out) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::Overlap");
+
+  CollectOverlaps(collider);
+  size_t count = std::min(out.size(), overlaps_.size());
+  for (size_t i = 0; i < count; ++i) {
+    out[i] = colliders_[overlaps_[i]];
+  }
+
+  return overlaps_.size();
+}
+
+bool Physics::AnyOverlap(const Collider& collider) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::AnyOverlap");
+
+  Refresh();
+
+  overlaps_.clear();
+  QueryBounds(collider.GetGlobalBounds(), collider.GetCollisionMask(),
+              candidates_, overlaps_);
+  // Colliders outside the physics world have no stored shape.
+  if (collider.physics_id_ == 0) {
+    return std::ranges::any_of(overlaps_, [&](size_t other) {
+      return collider.CanCollideWith(*colliders_[other]) &&
+             collider.Collides(*colliders_[other]);
+    });
+  }
+
+  size_t index = collider.physics_index_;
+  return std::ranges::any_of(overlaps_, [&](size_t other) {
+    return other != index && store_.CanCollide(index, other) &&
+           store_.Overlaps(index, other);
+  });
+}
+
+std::optional<ColliderSweepHit> Physics::Sweep(
+    const Collider& collider, sf::Vector2f displacement) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::Sweep");
+
+  Refresh();
+
+  ColliderShape shape = collider.GetGlobalShape();
+  sf::FloatRect bounds = {shape.center - shape.half_extents,
+                          shape.half_extents * 2.F};
+  sf::Vector2f swept_min = {
+      bounds.position.x + std::min(displacement.x, 0.F),
+      bounds.position.y + std::min(displacement.y, 0.F)};
+  sf::Vector2f swept_max = {
+      bounds.position.x + bounds.size.x + std::max(displacement.x, 0.F),
+      bounds.position.y + bounds.size.y + std::max(displacement.y, 0.F)};
+  sf::FloatRect swept_bounds = {swept_min, swept_max - swept_min};
+
+  overlaps_.clear();
+  QueryBounds(swept_bounds, collider.GetCollisionMask(), candidates_,
+              overlaps_);
+
+  std::optional<ColliderSweepHit> hit;
+  for (size_t index : overlaps_) {
+    const Collider* other = colliders_[index];
+    if (other == &collider || !collider.CanCollideWith(*other)) {
       continue;
     }
 
-    if (collider.Collides(*other)) {
-      collisions.push_back(other);
+    std::optional<SweepContact> contact =
+        SweepShape(shape, displacement, store_.GetShape(index));
+    // Ties go to the collider added first, so that the result does not
+    // depend on the order of the candidates.
+    if (contact &&
+        (!hit || contact->time < hit->time ||
+         (contact->time == hit->time &&
+          other->physics_id_ < hit->collider->physics_id_))) {
+      hit = ColliderSweepHit{
+          .collider = other, .time = contact->time, .normal = contact->normal};
     }
   }
 
-  return collisions;
+  return hit;
 }
 
-void Physics::AddCollider(const Collider* collider) {
-  assert(collider);
-  colliders_.insert(collider);
+void Physics::QueryAABB(sf::FloatRect bounds, CollisionLayer mask,
+                        std::vector<const Collider*>& out) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::QueryAABB");
+
+  sf::Vector2f half_extents = bounds.size / 2.F;
+  QueryShape({.kind = ColliderShape::Kind::kRectangle,
+              .center = bounds.position + half_extents,
+              .half_extents = half_extents},
+             mask, out);
+}
+
+void Physics::QueryCircle(sf::Vector2f center, float radius,
+                          CollisionLayer mask,
+                          std::vector<const Collider*>& out) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::QueryCircle");
+
+  assert(radius >= 0);
+  QueryShape({.kind = ColliderShape::Kind::kCircle,
+              .center = center,
+              .half_extents = {radius, radius}},
+             mask, out);
+}
+
+void Physics::QueryPoint(sf::Vector2f point, CollisionLayer mask,
+                         std::vector<const Collider*>& out) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::QueryPoint");
+
+  // A point is a rectangle without extent, which the tests handle exactly.
+  QueryShape({.kind = ColliderShape::Kind::kRectangle,
+              .center = point,
+              .half_extents = {}},
+             mask, out);
+}
+
+void Physics::QueryNearest(sf::Vector2f point, size_t count,
+                           float max_distance, CollisionLayer mask,
+                           std::vector<const Collider*>& out) const {
+  NG_PROFILE_SCOPE("Physics", "Physics::QueryNearest");
+
+  assert(max_distance >= 0);
+  Refresh();
+  if (count == 0 || store_.GetSize() == 0) {
+    return;
+  }
+
+  // A collider within a distance of the point has bounds overlapping the
+  // square of that half size around the point. Squares of doubling size are
+  // queried until the nearest colliders found are all within the square.
+  max_distance = std::min(max_distance, kMaxNearestHalfSize);
+  float half_size = std::min(kCellSize, max_distance);
+  while (true) {
+    // Once the square covers more cells of the grid than there are colliders,
+    // scanning the store up to the maximum distance costs less.
+    float cells = 2.F * half_size / kCellSize;
+    bool is_scanning =
+        IsScanning() ||
+        cells * cells > static_cast<float>(store_.GetSize());
+    if (is_scanning) {
+      half_size = max_distance;
+    }
+
+    sf::FloatRect square = {point - sf::Vector2f(half_size, half_size),
+                            {2.F * half_size, 2.F * half_size}};
+    overlaps_.clear();
+    if (is_scanning) {
+      store_.QueryBounds(square, mask, overlaps_);
+    } else {
+      QueryBounds(square, mask, candidates_, overlaps_);
+    }
+
+    nearest_.clear();
+    for (size_t index : overlaps_) {
+      float distance = store_.GetDistance(index, point);
+      if (distance <= max_distance) {
+        nearest_.push_back({.distance = distance,
+                            .id = colliders_[index]->physics_id_,
+                            .index = index});
+      }
+    }
+    size_t found = std::min(count, nearest_.size());
+    std::ranges::partial_sort(nearest_, nearest_.begin() + found);
+
+    if (half_size >= max_distance ||
+        (found == count && nearest_[found - 1].distance <= half_size)) {
+      for (size_t i = 0; i < found; ++i) {
+        out.push_back(colliders_[nearest_[i].index]);
+      }
+      return;
+    }
+
+    half_size = std::min(2.F * half_size, max_distance);
+  }
+}
+
+void Physics::UpdateContacts() {
+  NG_PROFILE_SCOPE("Physics", "Physics::UpdateContacts");
+
+  Refresh();
+
+  std::swap(previous_contacts_, contacts_);
+  contacts_.clear();
+  for (size_t index = 0; index < colliders_.size(); ++index) {
+    const Collider* collider = colliders_[index];
+    overlaps_.clear();
+    // Each pair is found by the collider stored first, so that it is tested
+    // once. The contacts are ordered by registration for the callbacks.
+    FindOverlaps(index, index + 1, candidates_, overlaps_);
+    for (size_t other_index : overlaps_) {
+      const Collider* other = colliders_[other_index];
+      auto [first, second] = collider->physics_id_ < other->physics_id_
+                                 ? std::pair(collider, other)
+                                 : std::pair(other, collider);
+      contacts_.push_back({.first_id = first->physics_id_,
+                           .second_id = second->physics_id_,
+                           .first = first,
+                           .second = second});
+    }
+  }
+  std::ranges::sort(contacts_);
+
+  // Both lists are sorted, so a single merge finds the pairs that only exist
+  // in one of them. Nodes cannot be added or removed during the callbacks,
+  // so both lists stay valid.
+  auto previous = previous_contacts_.begin();
+  auto current = contacts_.begin();
+  while (previous != previous_contacts_.end() || current != contacts_.end()) {
+    if (current == contacts_.end() ||
+        (previous != previous_contacts_.end() && *previous < *current)) {
+      previous->first->GetParent()->OnCollisionExit(*previous->first,
+                                                    *previous->second);
+      previous->second->GetParent()->OnCollisionExit(*previous->second,
+                                                     *previous->first);
+      ++previous;
+    } else if (previous == previous_contacts_.end() || *current < *previous) {
+      current->first->GetParent()->OnCollisionEnter(*current->first,
+                                                    *current->second);
+      current->second->GetParent()->OnCollisionEnter(*current->second,
+                                                     *current->first);
+      ++current;
+    } else {
+      current->first->GetParent()->OnCollisionStay(*current->first,
+                                                   *current->second);
+      current->second->GetParent()->OnCollisionStay(*current->second,
+                                                    *current->first);
+      ++previous;
+      ++current;
+    }
+  }
 }
 
-void Physics::RemoveCollider(const Collider* collider) {
+void Physics::AddCollider(Collider* collider) {
+  assert(collider && collider->physics_id_ == 0);
+  collider->physics_id_ = next_collider_id_;
+  ++next_collider_id_;
+  collider->physics_index_ = colliders_.size();
+  colliders_.push_back(collider);
+  store_.Add(collider->GetGlobalShape(), collider->GetCollisionCategory(),
+             collider->GetCollisionMask());
+  if (broadphase_) {
+    broadphase_->Insert(collider);
+  }
+}
+
+void Physics::RemoveCollider(Collider* collider) {
+  assert(collider && colliders_[collider->physics_index_] == collider);
+  if (broadphase_) {
+    broadphase_->Remove(collider);
+  }
+  if (collider->is_shape_dirty_) {
+    collider->is_shape_dirty_ = false;
+    std::erase(dirty_colliders_, collider);
+  }
+
+  // The store moves its last entry in place of the removed one, as here.
+  store_.Remove(collider->physics_index_);
+  Collider* moved = colliders_.back();
+  moved->physics_index_ = collider->physics_index_;
+  colliders_[collider->physics_index_] = moved;
+  colliders_.pop_back();
+
+  // The pairs of the collider end now, while it can still be passed to the
+  // callbacks. Erasing them keeps the remaining contacts sorted. The other
+  // colliders are moved out of exited_colliders_ while they are notified, in
+  // case a callback removes another collider.
+  std::vector<const Collider*> others = std::move(exited_colliders_);
+  others.clear();
+  std::erase_if(contacts_, [collider, &others](const Contact& contact) {
+    if (contact.first != collider && contact.second != collider) {
+      return false;
+    }
+
+    others.push_back(contact.first == collider ? contact.second
+                                               : contact.first);
+    return true;
+  });
+  collider->physics_id_ = 0;
+
+  for (const Collider* other : others) {
+    other->GetParent()->OnCollisionExit(*other, *collider);
+  }
+  exited_colliders_ = std::move(others);
+}
+
+void Physics::MarkColliderDirty(Collider* collider) {
   assert(collider);
-  colliders_.erase(collider);
+  if (broadphase_) {
+    broadphase_->MarkDirty(collider);
+  }
+  if (collider->physics_id_ != 0 && !collider->is_shape_dirty_) {
+    collider->is_shape_dirty_ = true;
+    dirty_colliders_.push_back(collider);
+  }
+}
+
+void Physics::UpdateColliderLayers(const Collider* collider) {
+  assert(collider && collider->physics_id_ != 0);
+  store_.SetLayers(collider->physics_index_, collider->GetCollisionCategory(),
+                   collider->GetCollisionMask());
+  if (broadphase_) {
+    broadphase_->UpdateCategory(collider);
+  }
+}
+
+void Physics::Refresh() const {
+  for (Collider* collider : dirty_colliders_) {
+    collider->is_shape_dirty_ = false;
+    store_.SetShape(collider->physics_index_, collider->GetGlobalShape());
+  }
+  dirty_colliders_.clear();
+
+  if (broadphase_) {
+    broadphase_->Refresh();
+  }
+}
+
+bool Physics::IsScanning() const {
+  return broadphase_kind_ == PhysicsBroadphase::kScan;
+}
+
+void Physics::QueryBounds(sf::FloatRect bounds, CollisionLayer mask,
+                          std::vector<const Collider*>& candidates,
+                          std::vector<size_t>& out) const {
+  if (IsScanning()) {
+    store_.QueryBounds(bounds, mask, out);
+    return;
+  }
+
+  candidates.clear();
+  broadphase_->Query(bounds, mask, candidates);
+  for (const Collider* candidate : candidates) {
+    out.push_back(candidate->physics_index_);
+  }
+}
+
+void Physics::CollectOverlaps(const Collider& collider) const {
+  Refresh();
+
+  overlaps_.clear();
+  if (collider.physics_id_ != 0) {
+    FindOverlaps(collider.physics_index_, 0, candidates_, overlaps_);
+    return;
+  }
+
+  // Colliders outside the physics world have no stored shape.
+  QueryBounds(collider.GetGlobalBounds(), collider.GetCollisionMask(),
+              candidates_, overlaps_);
+  std::erase_if(overlaps_, [&](size_t other) {
+    return !collider.CanCollideWith(*colliders_[other]) ||
+           !collider.Collides(*colliders_[other]);
+  });
+}
+
+void Physics::QueryShape(const ColliderShape& shape, CollisionLayer mask,
+                         std::vector<const Collider*>& out) const {
+  Refresh();
+
+  overlaps_.clear();
+  QueryBounds({shape.center - shape.half_extents, shape.half_extents * 2.F},
+              mask, candidates_, overlaps_);
+  for (size_t index : overlaps_) {
+    if (store_.Overlaps(index, shape)) {
+      out.push_back(colliders_[index]);
+    }
+  }
+}
+
+void Physics::FindOverlaps(size_t index, size_t first_other,
+                           std::vector<const Collider*>& candidates,
+                           std::vector<size_t>& out) const {
+  if (IsScanning()) {
+    store_.FindOverlaps(index, first_other, out);
+    return;
+  }
+
+  candidates.clear();
+  broadphase_->Query(store_.GetBounds(index),
+                     colliders_[index]->GetCollisionMask(), candidates);
+  for (const Collider* other : candidates) {
+    size_t other_index = other->physics_index_;
+    if (other_index != index && other_index >= first_other &&
+        store_.CanCollide(index, other_index) &&
+        store_.Overlaps(index, other_index)) {
+      out.push_back(other_index);
+    }
+  }
 }
 
 }  // namespace ng
\ No newline at end of file
@@ -1,35 +1,265 @@
 #pragma once
 
-#include <unordered_set>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include "broadphase.h"
 #include "collider.h"
+#include "collider_store.h"
+#include "collision_layer.h"
 
 namespace ng {
 
+/// @brief The broadphases a physics world can find its collision candidates with.
+enum class PhysicsBroadphase : uint8_t {
+  /// @brief Scans the bounds of every collider on each query. The reference for the other broadphases, and the fastest in small worlds, up to about a hundred colliders.
+  kScan,
+  /// @brief A uniform grid of cells about the size of a character, fastest when most colliders are about that size.
+  kSpatialHash,
+  /// @brief A dynamic tree of fattened bounding boxes. Its queries cost more than a lookup in a grid suited to the world, but do not depend on a cell size, so it suits worlds whose collider sizes vary too much for any one cell size.
+  kDynamicTree,
+};
+
+/// @brief The first collider hit by a collider swept through a physics world.
+struct ColliderSweepHit {
+  // The collider that was hit. Never null.
+  const Collider* collider = nullptr;
+  // The fraction of the displacement covered before the contact, between 0 and 1. 0 if the colliders overlap from the start.
+  float time = 0;
+  // The outward normal of the hit collider at the contact point. Zero if the colliders overlap from the start.
+  sf::Vector2f normal;
+};
+
 /// @brief Manages the physics simulation within a scene, primarily handling collision detection.
 class Physics {
-  // Collider needs to be able to call AddCollider, and RemoveCollider.
+  // Collider needs to be able to call AddCollider, RemoveCollider, MarkColliderDirty, and UpdateColliderLayers.
   friend class Collider;
 
  public:
+  /// @brief Constructs an empty physics world.
+  /// @param broadphase The broadphase used to find collision candidates.
+  explicit Physics(
+      PhysicsBroadphase broadphase = PhysicsBroadphase::kSpatialHash);
+
+  /// @brief Returns the broadphase used to find collision candidates.
+  /// @return The PhysicsBroadphase of the physics world.
+  [[nodiscard]] PhysicsBroadphase GetBroadphase() const;
+
   /// @brief Checks if a given collider overlaps with any other collider currently in the physics world.
+  ///        Only the colliders whose layers allow the collision and whose bounds overlap those of the given collider are tested.
+  ///        The bounds are found by scanning every collider or through the broadphase, depending on the broadphase selected and the size of the world.
+  ///        Allocates the returned vector. Code running every tick should prefer the other overloads, ForEachOverlap or AnyOverlap.
   /// @param collider The Collider to check for overlaps.
   /// @return A vector of pointers to the Colliders that overlaps with the given collider, empty if no overlap is found.
   [[nodiscard]] std::vector<const Collider*> Overlap(
       const Collider& collider) const;
 
+  /// @brief Appends to `out` every collider overlapping the given collider, as found by Overlap.
+  ///        Does not allocate once `out` and the internal buffers of the physics world have grown to fit the results, so that a vector kept by the caller can be cleared and reused every tick.
+  /// @param collider The Collider to check for overlaps.
+  /// @param out The vector the overlapping colliders are appended to.
+  void Overlap(const Collider& collider,
+               std::vector<const Collider*>& out) const;
+
+  /// @brief Writes to `out` the colliders overlapping the given collider, as found by Overlap, up to the size of `out`.
+  ///        Never allocates once the internal buffers of the physics world have grown to fit the results, so that a fixed-capacity array can hold the results.
+  /// @param collider The Collider to check for overlaps.
+  /// @param out The buffer the overlapping colliders are written to, from its start. The colliders that do not fit are left out.
+  /// @return The number of overlapping colliders, which is more than the size of `out` if some were left out.
+  size_t Overlap(const Collider& collider,
+                 std::span<const Collider*> out) const;
+
+  /// @brief Calls a callback with every collider overlapping the given collider, as found by Overlap, without allocating once the internal buffers of the physics world have grown to fit the results.
+  ///        The callback may query the physics world, but must not add, remove or move colliders.
+  /// @tparam Callback A callable taking a constant reference to a Collider.
+  /// @param collider The Collider to check for overlaps.
+  /// @param callback The callable to call with each overlapping collider.
+  template <std::invocable<const Collider&> Callback>
+  void ForEachOverlap(const Collider& collider, Callback&& callback) const {
+    CollectOverlaps(collider);
+    // A callback querying the physics world again reuses overlaps_, so the
+    // results are moved out while they are visited and given back after.
+    std::vector<size_t> overlaps = std::move(overlaps_);
+    for (size_t index : overlaps) {
+      callback(static_cast<const Collider&>(*colliders_[index]));
+    }
+    overlaps_ = std::move(overlaps);
+  }
+
+  /// @brief Checks if a given collider overlaps any other collider of the physics world, as found by Overlap.
+  ///        Stops at the first overlapping collider found and never allocates once the internal buffers of the physics world have grown.
+  /// @param collider The Collider to check for overlaps.
+  /// @return True if at least one collider overlaps the given collider, false otherwise.
+  [[nodiscard]] bool AnyOverlap(const Collider& collider) const;
+
+  /// @brief Moves a collider by a displacement and finds the first collider of the physics world it would hit, without moving it.
+  ///        Unlike Overlap, colliders between the start and the end of the move are found, so that fast colliders do not pass through thin ones.
+  ///        Only the colliders whose layers allow the collision and whose bounds overlap the bounds swept by the collider are tested.
+  /// @param collider The Collider to sweep, at its position before the move. It does not need to be part of the physics world.
+  /// @param displacement The world space displacement of the collider.
+  /// @return The first collider hit and the time of the hit, or nullopt if the way is free.
+  [[nodiscard]] std::optional<ColliderSweepHit> Sweep(
+      const Collider& collider, sf::Vector2f displacement) const;
+
+  /// @brief Appends to `out` every collider overlapping an axis-aligned rectangle, without needing a collider for the rectangle.
+  ///        Touching shapes overlap, as in the collider tests. Only the colliders whose category shares a layer with the mask are tested, whatever their own mask.
+  ///        Like the other queries, it goes through the broadphase of the physics world and does not allocate once `out` and the internal buffers have grown.
+  /// @param bounds The world space rectangle.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the overlapping colliders are appended to.
+  void QueryAABB(sf::FloatRect bounds, CollisionLayer mask,
+                 std::vector<const Collider*>& out) const;
+
+  /// @brief Appends to `out` every collider overlapping a circle, without needing a collider for the circle, with the same rules as QueryAABB.
+  /// @param center The world space center of the circle.
+  /// @param radius The radius of the circle. Must not be negative.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the overlapping colliders are appended to.
+  void QueryCircle(sf::Vector2f center, float radius, CollisionLayer mask,
+                   std::vector<const Collider*>& out) const;
+
+  /// @brief Appends to `out` every collider containing a point, with the same rules as QueryAABB. Points on the edge of a collider are contained.
+  /// @param point The world space point.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the colliders containing the point are appended to.
+  void QueryPoint(sf::Vector2f point, CollisionLayer mask,
+                  std::vector<const Collider*>& out) const;
+
+  /// @brief Appends to `out` the colliders closest to a point, nearest first, with the same rules as QueryAABB.
+  ///        The distance to a collider is the distance to the closest point of its shape, 0 for the colliders containing the point. Ties go to the collider added first.
+  ///        The broadphase is queried with squares of doubling size around the point until they hold enough colliders, so nearby colliders are found without testing the whole world.
+  /// @param point The world space point.
+  /// @param count The maximum number of colliders to report.
+  /// @param max_distance The distance beyond which colliders are not reported. May be infinite.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the nearest colliders are appended to.
+  void QueryNearest(sf::Vector2f point, size_t count, float max_distance,
+                    CollisionLayer mask,
+                    std::vector<const Collider*>& out) const;
+
+  /// @brief Finds every pair of overlapping colliders and notifies the parents of both colliders of the pairs that started, kept or stopped overlapping since the last call.
+  ///        Each pair is tested once, and only if the layers of its colliders allow the collision. Notifications are sent in the order the colliders were added, through OnCollisionEnter, OnCollisionStay and OnCollisionExit.
+  ///        Called by the Scene once per tick, after the update phase.
+  void UpdateContacts();
+
  private:
   /// @brief Adds a collider to the physics world for collision detection. Called by Collider during its addition to a scene.
   /// @param collider A pointer to the Collider to add. This pointer must not be null and the Collider's lifetime should be managed externally to this class.
-  void AddCollider(const Collider* collider);
+  void AddCollider(Collider* collider);
 
   /// @brief Removes a collider from the physics world. Called by Collider during its removal from a scene.
+  ///        The parents of the colliders it was overlapping are notified through OnCollisionExit immediately.
   /// @param collider A pointer to the Collider to remove. This pointer must not be null and the Collider's lifetime should be managed externally to this class.
-  void RemoveCollider(const Collider* collider);
+  void RemoveCollider(Collider* collider);
+
+  /// @brief Schedules the shape and broadphase updates of a collider whose global transform changed. Called by Collider.
+  /// @param collider A pointer to the Collider that moved. This pointer must not be null.
+  void MarkColliderDirty(Collider* collider);
+
+  /// @brief Updates the stored collision layers of a collider and reindexes it in the broadphase. Called by Collider.
+  /// @param collider A pointer to the Collider whose category or mask changed. This pointer must not be null.
+  void UpdateColliderLayers(const Collider* collider);
+
+  /// @brief Applies the pending collider moves to the collider store and the broadphase.
+  void Refresh() const;
+
+  /// @brief Checks if the queries scan the collider store rather than going through the broadphase.
+  /// @return True if the broadphase is kScan.
+  [[nodiscard]] bool IsScanning() const;
+
+  /// @brief Appends to `out` the store index of every collider whose bounds may overlap the given bounds and whose category shares a layer with the mask. Refresh must be called beforehand.
+  /// @param bounds The world space bounds to query.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param candidates A vector used to hold the broadphase candidates. Its previous content is discarded.
+  /// @param out The vector the indices are appended to.
+  void QueryBounds(sf::FloatRect bounds, CollisionLayer mask,
+                   std::vector<const Collider*>& candidates,
+                   std::vector<size_t>& out) const;
+
+  /// @brief Replaces the content of overlaps_ by the store index of every collider overlapping the given collider, applying the pending collider moves first.
+  /// @param collider The Collider to check for overlaps. It does not need to be part of the physics world.
+  void CollectOverlaps(const Collider& collider) const;
+
+  /// @brief Appends to `out` every collider overlapping a world space shape, for the shape queries.
+  /// @param shape The world space shape to test.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the overlapping colliders are appended to.
+  void QueryShape(const ColliderShape& shape, CollisionLayer mask,
+                  std::vector<const Collider*>& out) const;
+
+  /// @brief Appends to `out` the store index of every collider overlapping a collider of the physics world, among the colliders from a given store index. Refresh must be called beforehand.
+  ///        The colliders before that index are skipped before any exact test.
+  /// @param index The store index of the collider.
+  /// @param first_other The store index of the first collider to test against the collider.
+  /// @param candidates A vector used to hold the broadphase candidates. Its previous content is discarded.
+  /// @param out The vector the indices are appended to.
+  void FindOverlaps(size_t index, size_t first_other,
+                    std::vector<const Collider*>& candidates,
+                    std::vector<size_t>& out) const;
+
+  /// @brief Two overlapping colliders, ordered by registration.
+  struct Contact {
+    // The registration id of first.
+    uint64_t first_id = 0;
+    // The registration id of second, greater than first_id.
+    uint64_t second_id = 0;
+    // The collider added first. Never null.
+    const Collider* first = nullptr;
+    // The collider added second. Never null.
+    const Collider* second = nullptr;
+
+    auto operator<=>(const Contact& other) const = default;
+  };
+
+  /// @brief A candidate of QueryNearest, ordered by distance then by registration.
+  struct NearbyCollider {
+    // The distance from the queried point to the shape of the collider.
+    float distance = 0;
+    // The registration id of the collider.
+    uint64_t id = 0;
+    // The store index of the collider.
+    size_t index = 0;
+
+    auto operator<=>(const NearbyCollider& other) const = default;
+  };
+
+  // All the colliders in the physics world, in no particular order. The Physics class does not own the colliders.
+  std::vector<Collider*> colliders_;
+  // The shapes and layers of the colliders, indexed like colliders_.
+  // Mutable because queries lazily apply the pending collider moves.
+  mutable ColliderStore store_;
+  // The colliders whose shape changed since the last refresh.
+  mutable std::vector<Collider*> dirty_colliders_;
+  // The registration id given to the next collider added.
+  uint64_t next_collider_id_ = 1;
+  // The overlapping pairs found by the last UpdateContacts, sorted.
+  std::vector<Contact> contacts_;
+  // The overlapping pairs of the previous UpdateContacts. Kept to reuse its memory.
+  std::vector<Contact> previous_contacts_;
+  // The broadphase candidates of the collider being tested. Kept to reuse its memory.
+  // Mutable, as the buffers below, because queries reuse it.
+  mutable std::vector<const Collider*> candidates_;
+  // The store indices of the colliders overlapping the collider being tested, or of the candidates of a sweep. Kept to reuse its memory.
+  mutable std::vector<size_t> overlaps_;
+  // The candidates of the current QueryNearest. Kept to reuse its memory.
+  mutable std::vector<NearbyCollider> nearest_;
+  // The colliders whose pairs with a removed collider ended. Kept to reuse its memory.
+  std::vector<const Collider*> exited_colliders_;
 
-  // A set containing pointers to all colliders in the physics world. The Physics class does not own these pointers.
-  std::unordered_set<const Collider*> colliders_;
+  // The kind of broadphase_.
+  PhysicsBroadphase broadphase_kind_;
+  // The broadphase containing all colliders in the physics world, null for kScan. The Physics class does not own the colliders.
+  // Queries lazily apply the pending collider moves to it, which the pointer allows from const methods.
+  std::unique_ptr<Broadphase> broadphase_;
 };
 
 }  // namespace ng
\ No newline at end of file
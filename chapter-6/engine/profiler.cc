@@ -0,0 +1,145 @@
+#include "profiler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace ng {
+
+namespace {
+
+/// @brief Returns a small index identifying the calling thread, assigned in order of first use.
+uint32_t GetThreadIndex() {
+  static std::atomic<uint32_t> next_index = 0;
+  thread_local const uint32_t index = next_index++;
+  return index;
+}
+
+/// @brief Returns the human-readable form of a type name returned by std::type_info::name.
+std::string Demangle(const char* name) {
+#if defined(__GNUG__)
+  int status = 0;
+  std::unique_ptr<char, decltype(&std::free)> demangled(
+      abi::__cxa_demangle(name, nullptr, nullptr, &status), &std::free);
+  if (status == 0) {
+    return demangled.get();
+  }
+#endif
+  // MSVC already returns readable names.
+  return name;
+}
+
+/// @brief Writes a string as a JSON string literal.
+void WriteJsonString(std::ofstream& out, const std::string& value) {
+  out << '"';
+  for (char c : value) {
+    if (c == '"' || c == '\\') {
+      out << '\\';
+    }
+    out << c;
+  }
+  out << '"';
+}
+
+/// @brief Converts a duration to the fractional microseconds used by the trace format.
+double ToMicroseconds(std::chrono::nanoseconds duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+
+}  // namespace
+
+Profiler& Profiler::Get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+Profiler::Profiler() : epoch_(std::chrono::steady_clock::now()) {}
+
+void Profiler::Record(const char* category, const char* name,
+                      bool is_type_name,
+                      std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end) {
+  uint32_t thread_index = GetThreadIndex();
+
+  std::scoped_lock lock(mutex_);
+  if (zones_.size() >= kMaxZones) {
+    ++dropped_zone_count_;
+    return;
+  }
+
+  zones_.push_back({.category = category,
+                    .name = name,
+                    .is_type_name = is_type_name,
+                    .thread_index = thread_index,
+                    .start = start - epoch_,
+                    .duration = end - start});
+}
+
+void Profiler::Clear() {
+  std::scoped_lock lock(mutex_);
+  zones_.clear();
+  dropped_zone_count_ = 0;
+}
+
+bool Profiler::WriteChromeTrace(const std::filesystem::path& path) const {
+  std::ofstream out(path);
+  if (!out) {
+    return false;
+  }
+
+  std::scoped_lock lock(mutex_);
+  // Fixed notation keeps sub-microsecond precision on long sessions.
+  out << std::fixed << std::setprecision(3);
+  out << "{\"traceEvents\":[";
+  for (size_t i = 0; i < zones_.size(); ++i) {
+    const Zone& zone = zones_[i];
+    if (i > 0) {
+      out << ',';
+    }
+    out << "\n{\"name\":";
+    WriteJsonString(out, zone.is_type_name ? Demangle(zone.name) : zone.name);
+    out << ",\"cat\":";
+    WriteJsonString(out, zone.category);
+    out << ",\"ph\":\"X\",\"ts\":" << ToMicroseconds(zone.start)
+        << ",\"dur\":" << ToMicroseconds(zone.duration)
+        << ",\"pid\":0,\"tid\":" << zone.thread_index << '}';
+  }
+  out << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedZones\":"
+      << dropped_zone_count_ << "}}\n";
+
+  return static_cast<bool>(out);
+}
+
+ProfileZone::ProfileZone(const char* category, const char* name)
+    : profiler_(Profiler::Get()),
+      category_(category),
+      name_(name),
+      is_type_name_(false),
+      start_(std::chrono::steady_clock::now()) {}
+
+ProfileZone::ProfileZone(const char* category, const std::type_info& type)
+    : profiler_(Profiler::Get()),
+      category_(category),
+      name_(type.name()),
+      is_type_name_(true),
+      start_(std::chrono::steady_clock::now()) {}
+
+ProfileZone::~ProfileZone() {
+  profiler_.Record(category_, name_, is_type_name_, start_,
+                   std::chrono::steady_clock::now());
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <typeinfo>
+#include <vector>
+
+namespace ng {
+
+/// @brief Collects timed zones of the engine and exports them in the Chrome trace event format, viewable in chrome://tracing or Perfetto.
+///        Zones are normally recorded through the NG_PROFILE_SCOPE and NG_PROFILE_TYPE_SCOPE macros, which compile out unless NG_PROFILE is defined.
+class Profiler {
+ public:
+  /// @brief Returns the process-wide profiler.
+  /// @return A reference to the Profiler instance.
+  static Profiler& Get();
+
+  Profiler(const Profiler& other) = delete;
+  Profiler& operator=(const Profiler& other) = delete;
+  Profiler(Profiler&& other) = delete;
+  Profiler& operator=(Profiler&& other) = delete;
+
+  /// @brief Records a completed zone. Thread-safe. Zones are dropped once kMaxZones zones are recorded.
+  /// @param category The category of the zone. Must point to a string with static storage duration.
+  /// @param name The name of the zone. Must point to a string with static storage duration.
+  /// @param is_type_name True if name is a mangled type name that must be demangled on export.
+  /// @param start The time at which the zone started.
+  /// @param end The time at which the zone ended.
+  void Record(const char* category, const char* name, bool is_type_name,
+              std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end);
+
+  /// @brief Discards all the recorded zones.
+  void Clear();
+
+  /// @brief Writes all the recorded zones to a Chrome trace JSON file.
+  /// @param path The path of the file to write.
+  /// @return True if the file was written successfully, false otherwise.
+  bool WriteChromeTrace(const std::filesystem::path& path) const;
+
+ private:
+  /// @brief A completed zone.
+  struct Zone {
+    const char* category = nullptr;
+    const char* name = nullptr;
+    bool is_type_name = false;
+    uint32_t thread_index = 0;
+    // Start time and duration, relative to the creation of the profiler.
+    std::chrono::nanoseconds start;
+    std::chrono::nanoseconds duration;
+  };
+
+  // The maximum number of zones kept in memory, to bound the memory used by long sessions.
+  static constexpr size_t kMaxZones = size_t{1} << 22U;
+
+  Profiler();
+
+  // The time all zone timestamps are relative to.
+  std::chrono::steady_clock::time_point epoch_;
+  // Protects zones_ and dropped_zone_count_.
+  mutable std::mutex mutex_;
+  // The recorded zones, in order of completion.
+  std::vector<Zone> zones_;
+  // The number of zones recorded after kMaxZones was reached.
+  size_t dropped_zone_count_ = 0;
+};
+
+/// @brief Measures the lifetime of a scope and records it to the Profiler on destruction.
+class ProfileZone {
+ public:
+  /// @brief Starts a zone with a fixed name.
+  /// @param category The category of the zone. Must point to a string with static storage duration.
+  /// @param name The name of the zone. Must point to a string with static storage duration.
+  ProfileZone(const char* category, const char* name);
+
+  /// @brief Starts a zone named after a type, typically the dynamic type of a node.
+  /// @param category The category of the zone. Must point to a string with static storage duration.
+  /// @param type The type whose name is used for the zone.
+  ProfileZone(const char* category, const std::type_info& type);
+
+  ~ProfileZone();
+
+  ProfileZone(const ProfileZone& other) = delete;
+  ProfileZone& operator=(const ProfileZone& other) = delete;
+  ProfileZone(ProfileZone&& other) = delete;
+  ProfileZone& operator=(ProfileZone&& other) = delete;
+
+ private:
+  // Initialized before start_, so that the profiler epoch precedes the first zone.
+  Profiler& profiler_;
+  const char* category_;
+  const char* name_;
+  bool is_type_name_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace ng
+
+#define NG_PROFILE_CONCAT_IMPL(a, b) a##b
+#define NG_PROFILE_CONCAT(a, b) NG_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef NG_PROFILE
+/// @brief Records the enclosing scope as a zone with a fixed name.
+#define NG_PROFILE_SCOPE(category, name) \
+  const ::ng::ProfileZone NG_PROFILE_CONCAT(ng_profile_zone_, __LINE__)(category, name)
+/// @brief Records the enclosing scope as a zone named after the dynamic type of an object.
+#define NG_PROFILE_TYPE_SCOPE(category, object) \
+  const ::ng::ProfileZone NG_PROFILE_CONCAT(ng_profile_zone_, __LINE__)(category, typeid(object))
+#else
+#define NG_PROFILE_SCOPE(category, name) static_cast<void>(0)
+#define NG_PROFILE_TYPE_SCOPE(category, object) static_cast<void>(0)
+#endif
\ No newline at end of file
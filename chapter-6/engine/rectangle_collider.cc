@@ -4,7 +4,9 @@
 #include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #endif
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <optional>
 
 #include "app.h"
 #include "circle_collider.h"
@@ -21,6 +23,21 @@ const sf::Vector2f& RectangleCollider::GetSize() const {
   return size_;
 }
 
+sf::FloatRect RectangleCollider::GetGlobalBounds() const {
+  sf::Vector2f size = size_.componentWiseMul(GetGlobalScale());
+  return {GetGlobalPosition() - (size / 2.F), size};
+}
+
+ColliderShape RectangleCollider::GetGlobalShape() const {
+  return {.kind = ColliderShape::Kind::kRectangle,
+          .center = GetGlobalPosition(),
+          .half_extents = size_.componentWiseMul(GetGlobalScale()) / 2.F};
+}
+
+std::optional<sf::FloatRect> RectangleCollider::GetLocalBounds() const {
+  return sf::FloatRect(-size_ / 2.F, size_);
+}
+
 bool RectangleCollider::Collides(const Collider& other) const {
   return other.Collides(*this);
 }
@@ -31,13 +48,12 @@ bool RectangleCollider::Collides(const CircleCollider& other) const {
 }
 
 bool RectangleCollider::Collides(const RectangleCollider& other) const {
-  sf::Vector2f pos = GetGlobalTransform().getPosition();
-  sf::Vector2f otherPos = other.GetGlobalTransform().getPosition();
+  sf::Vector2f pos = GetGlobalPosition();
+  sf::Vector2f otherPos = other.GetGlobalPosition();
   // Calculate the extents of both rectangles in world space.
-  sf::Vector2f halfSize =
-      size_.componentWiseMul(GetGlobalTransform().getScale()) / 2.F;
+  sf::Vector2f halfSize = size_.componentWiseMul(GetGlobalScale()) / 2.F;
   sf::Vector2f otherHalfSize =
-      other.size_.componentWiseMul(other.GetGlobalTransform().getScale()) / 2.F;
+      other.size_.componentWiseMul(other.GetGlobalScale()) / 2.F;
 
   // Check for non-overlapping conditions on both x and y axes.
   bool AisToTheRightOfB = pos.x - halfSize.x > otherPos.x + otherHalfSize.x;
@@ -56,7 +72,7 @@ void RectangleCollider::Draw(sf::RenderTarget& target) {
   shape.setOutlineThickness(2);
   shape.setFillColor(sf::Color::Transparent);
   shape.setOrigin(size_ / 2.F);
-  target.draw(shape, GetGlobalTransform().getTransform());
+  target.draw(shape, GetGlobalMatrix());
 }
 #endif
 
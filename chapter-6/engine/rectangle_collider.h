@@ -1,7 +1,9 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <optional>
 
 #include "collider.h"
 
@@ -19,6 +21,18 @@ class RectangleCollider : public Collider {
   /// @return A constant reference to the size vector.
   [[nodiscard]] const sf::Vector2f& GetSize() const;
 
+  /// @brief Returns the axis-aligned bounding box of the collider in world space.
+  /// @return The world space bounds of the collider.
+  [[nodiscard]] sf::FloatRect GetGlobalBounds() const override;
+
+  /// @brief Returns the geometry of the collider in world space.
+  /// @return The world space shape of the collider.
+  [[nodiscard]] ColliderShape GetGlobalShape() const override;
+
+  /// @brief Returns the bounds of the collider in its local space, centered on its origin.
+  /// @return The local bounds of the collider.
+  [[nodiscard]] std::optional<sf::FloatRect> GetLocalBounds() const override;
+
   /// @brief Checks for collision with another Collider. Uses double-dispatch.
   /// @param other A constant reference to the other Collider.
   /// @return True if a collision occurs, false otherwise.
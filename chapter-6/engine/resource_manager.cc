@@ -2,47 +2,251 @@
 
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <exception>
 #include <filesystem>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "thread_pool.h"
 
 namespace ng {
 
-sf::Texture& ResourceManager::LoadTexture(
-    const std::filesystem::path& filename) {
-  std::filesystem::path full_path =
-      std::filesystem::absolute(kPrefix_ / filename);
+namespace {
+
+/// @brief Completes an asynchronous load removed from the pending loads, waiting for its decoding if needed.
+///        Caches the resource and fulfills the future of the load. If the load failed, the exception
+///        is forwarded to the future and rethrown.
+template <typename TCache, typename TPendingLoadNode>
+typename TCache::mapped_type& CompletePendingLoad(TCache& cache,
+                                                  TPendingLoadNode node,
+                                                  std::mutex& mutex) {
+  auto& load = node.mapped();
+  try {
+    // The conversion from the decoded type, e.g. the texture upload, happens
+    // on the calling thread, outside of the lock.
+    typename TCache::mapped_type resource(load.decoded.get());
 
-  auto it = textures_.find(full_path);
-  if (it == textures_.end()) {
-    it = textures_.insert({full_path, sf::Texture(full_path)}).first;
+    std::scoped_lock lock(mutex);
+    auto& cached =
+        cache.try_emplace(std::move(node.key()), std::move(resource))
+            .first->second;
+    load.promise.set_value(&cached);
+    return cached;
+  } catch (...) {
+    load.promise.set_exception(std::current_exception());
+    throw;
   }
+}
+
+/// @brief Loads a resource synchronously, completing its asynchronous load instead if there is one.
+template <typename TCache, typename TPendingLoads>
+typename TCache::mapped_type& Load(TCache& cache, TPendingLoads& pending_loads,
+                                   const std::filesystem::path& full_path,
+                                   std::mutex& mutex) {
+  {
+    std::unique_lock lock(mutex);
+    auto it = cache.find(full_path);
+    if (it != cache.end()) {
+      return it->second;
+    }
 
-  return it->second;
+    auto pending_it = pending_loads.find(full_path);
+    if (pending_it != pending_loads.end()) {
+      auto node = pending_loads.extract(pending_it);
+      lock.unlock();
+      return CompletePendingLoad(cache, std::move(node), mutex);
+    }
+  }
+
+  // Decoded outside of the lock, so that loads on other threads are not
+  // blocked. If another thread loaded the same file meanwhile, its resource
+  // is kept.
+  typename TCache::mapped_type resource(full_path);
+  std::scoped_lock lock(mutex);
+  return cache.try_emplace(full_path, std::move(resource)).first->second;
 }
 
-sf::SoundBuffer& ResourceManager::LoadSoundBuffer(
-    const std::filesystem::path& filename) {
-  std::filesystem::path full_path =
-      std::filesystem::absolute(kPrefix_ / filename);
+/// @brief Starts decoding a resource on the thread pool, unless it is already cached or being loaded.
+template <typename TCache, typename TPendingLoads, typename TDecode>
+std::shared_future<typename TCache::mapped_type*> LoadAsync(
+    ThreadPool& thread_pool, TCache& cache, TPendingLoads& pending_loads,
+    std::filesystem::path full_path, TDecode decode, std::mutex& mutex) {
+  std::scoped_lock lock(mutex);
+  auto it = cache.find(full_path);
+  if (it != cache.end()) {
+    std::promise<typename TCache::mapped_type*> promise;
+    promise.set_value(&it->second);
+    return promise.get_future().share();
+  }
+
+  auto pending_it = pending_loads.find(full_path);
+  if (pending_it != pending_loads.end()) {
+    return pending_it->second.result;
+  }
 
-  auto it = sound_buffers_.find(full_path);
-  if (it == sound_buffers_.end()) {
-    it = sound_buffers_.insert({full_path, sf::SoundBuffer(full_path)}).first;
+  typename TPendingLoads::mapped_type load;
+  load.decoded = thread_pool.Submit(
+      [path = full_path, decode]() { return decode(path); });
+  load.result = load.promise.get_future().share();
+  auto result = load.result;
+  pending_loads.emplace(std::move(full_path), std::move(load));
+  return result;
+}
+
+/// @brief Completes the loads whose decoding is finished, until the deadline is reached.
+/// @return False if the deadline was reached, true otherwise.
+template <typename TCache, typename TPendingLoads>
+bool FinalizeReadyLoads(TCache& cache, TPendingLoads& pending_loads,
+                        std::chrono::steady_clock::time_point deadline,
+                        std::mutex& mutex) {
+  while (true) {
+    typename TPendingLoads::node_type node;
+    {
+      std::scoped_lock lock(mutex);
+      auto it = std::ranges::find_if(pending_loads, [](const auto& entry) {
+        return entry.second.decoded.wait_for(std::chrono::seconds(0)) ==
+               std::future_status::ready;
+      });
+      if (it == pending_loads.end()) {
+        return true;
+      }
+      node = pending_loads.extract(it);
+    }
+
+    try {
+      CompletePendingLoad(cache, std::move(node), mutex);
+    } catch (...) {  // NOLINT(bugprone-empty-catch)
+      // The error is reported through the future of the load.
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline) {
+      return false;
+    }
+  }
+}
+
+}  // namespace
+
+ResourceManager::ResourceManager(ThreadPool* thread_pool)
+    : thread_pool_(thread_pool), main_thread_id_(std::this_thread::get_id()) {
+  assert(thread_pool);
+}
+
+sf::Texture& ResourceManager::LoadTexture(
+    const std::filesystem::path& filename) {
+  if (std::this_thread::get_id() != main_thread_id_) {
+    return LoadTextureOffMainThread(GetFullPath(filename));
   }
+  return Load(textures_, pending_textures_, GetFullPath(filename), mutex_);
+}
 
-  return it->second;
+sf::SoundBuffer& ResourceManager::LoadSoundBuffer(
+    const std::filesystem::path& filename) {
+  return Load(sound_buffers_, pending_sound_buffers_, GetFullPath(filename),
+              mutex_);
 }
 
 sf::Font& ResourceManager::LoadFont(const std::filesystem::path& filename) {
-  std::filesystem::path full_path =
-      std::filesystem::absolute(kPrefix_ / filename);
+  return Load(fonts_, pending_fonts_, GetFullPath(filename), mutex_);
+}
+
+std::shared_future<sf::Texture*> ResourceManager::LoadTextureAsync(
+    const std::filesystem::path& filename) {
+  // Only the pixels are decoded on the worker, the GPU upload must happen on
+  // the main thread.
+  return LoadAsync(*thread_pool_, textures_, pending_textures_,
+                   GetFullPath(filename),
+                   [](const std::filesystem::path& path) -> sf::Image {
+                     return sf::Image(path);
+                   },
+                   mutex_);
+}
+
+std::shared_future<sf::SoundBuffer*> ResourceManager::LoadSoundBufferAsync(
+    const std::filesystem::path& filename) {
+  return LoadAsync(*thread_pool_, sound_buffers_, pending_sound_buffers_,
+                   GetFullPath(filename),
+                   [](const std::filesystem::path& path) -> sf::SoundBuffer {
+                     return sf::SoundBuffer(path);
+                   },
+                   mutex_);
+}
+
+std::shared_future<sf::Font*> ResourceManager::LoadFontAsync(
+    const std::filesystem::path& filename) {
+  return LoadAsync(*thread_pool_, fonts_, pending_fonts_,
+                   GetFullPath(filename),
+                   [](const std::filesystem::path& path) -> sf::Font {
+                     return sf::Font(path);
+                   },
+                   mutex_);
+}
 
-  auto it = fonts_.find(full_path);
-  if (it == fonts_.end()) {
-    it = fonts_.insert({full_path, sf::Font(full_path)}).first;
+void ResourceManager::FinalizePendingLoads(std::chrono::nanoseconds budget) {
+  auto deadline = std::chrono::steady_clock::now() + budget;
+  // Textures first, since they are the only loads with actual work left.
+  if (!FinalizeReadyLoads(textures_, pending_textures_, deadline, mutex_)) {
+    return;
   }
+  if (!FinalizeReadyLoads(sound_buffers_, pending_sound_buffers_, deadline,
+                          mutex_)) {
+    return;
+  }
+  FinalizeReadyLoads(fonts_, pending_fonts_, deadline, mutex_);
+}
+
+sf::Texture& ResourceManager::LoadTextureOffMainThread(
+    const std::filesystem::path& full_path) {
+  std::shared_future<sf::Texture*> result;
+  {
+    std::scoped_lock lock(mutex_);
+    auto it = textures_.find(full_path);
+    if (it != textures_.end()) {
+      return it->second;
+    }
+
+    auto pending_it = pending_textures_.find(full_path);
+    if (pending_it != pending_textures_.end() &&
+        pending_it->second.decoded.wait_for(std::chrono::seconds(0)) ==
+            std::future_status::ready) {
+      result = pending_it->second.result;
+    }
+  }
+
+  if (!result.valid()) {
+    sf::Image image(full_path);
 
-  return it->second;
+    std::scoped_lock lock(mutex_);
+    auto it = textures_.find(full_path);
+    if (it != textures_.end()) {
+      return it->second;
+    }
+
+    // Joins the asynchronous load of the texture if there is one, replacing
+    // its decoding, which may still be queued behind the calling task.
+    auto& load = pending_textures_[full_path];
+    if (!load.result.valid()) {
+      load.result = load.promise.get_future().share();
+    }
+    std::promise<sf::Image> decoded;
+    decoded.set_value(std::move(image));
+    load.decoded = decoded.get_future();
+    result = load.result;
+  }
+
+  return *result.get();
+}
+
+std::filesystem::path ResourceManager::GetFullPath(
+    const std::filesystem::path& filename) {
+  return std::filesystem::absolute(kPrefix_ / filename);
 }
 
 }  // namespace ng
\ No newline at end of file
@@ -2,19 +2,32 @@
 
 #include <SFML/Audio/SoundBuffer.hpp>
 #include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <chrono>
 #include <filesystem>
+#include <future>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
 
+#include "thread_pool.h"
+
 namespace ng {
 
 /// @brief Manages the loading and caching of game resources such as textures, sound buffers, and fonts.
 ///        Ensures that resources are loaded only once and provides access to them.
+///        Resources can also be loaded asynchronously: files are read and decoded on a ThreadPool, and the
+///        loads are completed on the main thread by FinalizePendingLoads, which the App calls every frame.
+///        All the load functions are thread-safe, so that scenes can be built on a background thread. Textures are only ever
+///        uploaded on the main thread, the thread constructing the resource manager.
 class ResourceManager {
  public:
-  ResourceManager() = default;
+  /// @brief Constructs a ResourceManager decoding asynchronous loads on the given pool.
+  /// @param thread_pool A pointer to the ThreadPool used by asynchronous loads. This pointer must not be null and must outlive the resource manager.
+  explicit ResourceManager(ThreadPool* thread_pool);
   ~ResourceManager() = default;
 
   ResourceManager(const ResourceManager& other) = delete;
@@ -23,30 +36,100 @@ class ResourceManager {
   ResourceManager& operator=(ResourceManager&& other) = delete;
 
   /// @brief Loads a texture from the specified file path. If the texture is already loaded, returns the cached instance.
+  ///        If the texture is being loaded asynchronously, waits for its decoding and completes the load immediately.
+  ///        Off the main thread, the image is decoded on the calling thread and the call waits for FinalizePendingLoads to upload it.
   /// @param filename The relative path to the texture file.
   /// @return A reference to the loaded SFML Texture. Lifetime is bound to the resource manager instance.
   sf::Texture& LoadTexture(const std::filesystem::path& filename);
 
   /// @brief Loads a sound buffer from the specified file path. If the sound buffer is already loaded, returns the cached instance.
+  ///        If the sound buffer is being loaded asynchronously, waits for its decoding and completes the load immediately.
   /// @param filename The relative path to the sound buffer file.
   /// @return A reference to the loaded SFML SoundBuffer. Lifetime is bound to the resource manager instance.
   sf::SoundBuffer& LoadSoundBuffer(const std::filesystem::path& filename);
 
   /// @brief Loads a font from the specified file path. If the font is already loaded, returns the cached instance.
+  ///        If the font is being loaded asynchronously, waits for its decoding and completes the load immediately.
   /// @param filename The relative path to the font file.
   /// @return A reference to the loaded SFML Font. Lifetime is bound to the resource manager instance.
   sf::Font& LoadFont(const std::filesystem::path& filename);
 
+  /// @brief Starts loading a texture in the background. The image is decoded on a worker thread and uploaded to the GPU by FinalizePendingLoads.
+  /// @param filename The relative path to the texture file.
+  /// @return A future becoming ready once the texture is uploaded, holding a pointer to the cached texture, or the exception thrown by the load. Ready immediately if the texture is already loaded.
+  std::shared_future<sf::Texture*> LoadTextureAsync(
+      const std::filesystem::path& filename);
+
+  /// @brief Starts loading a sound buffer in the background. The file is decoded on a worker thread and cached by FinalizePendingLoads.
+  /// @param filename The relative path to the sound buffer file.
+  /// @return A future becoming ready once the sound buffer is cached, holding a pointer to it, or the exception thrown by the load. Ready immediately if the sound buffer is already loaded.
+  std::shared_future<sf::SoundBuffer*> LoadSoundBufferAsync(
+      const std::filesystem::path& filename);
+
+  /// @brief Starts loading a font in the background. The file is opened on a worker thread and cached by FinalizePendingLoads.
+  /// @param filename The relative path to the font file.
+  /// @return A future becoming ready once the font is cached, holding a pointer to it, or the exception thrown by the load. Ready immediately if the font is already loaded.
+  std::shared_future<sf::Font*> LoadFontAsync(
+      const std::filesystem::path& filename);
+
+  /// @brief Completes the asynchronous loads whose decoding has finished, until the time budget is exhausted. Must be called on the main thread.
+  ///        At least one ready load is completed per call, so that loads always make progress.
+  /// @param budget The maximum time to spend completing loads.
+  void FinalizePendingLoads(std::chrono::nanoseconds budget);
+
  private:
+  /// @brief An asynchronous load waiting to be completed on the main thread.
+  /// @tparam TResource The type of the cached resource.
+  /// @tparam TDecoded The type produced by the worker thread.
+  template <typename TResource, typename TDecoded>
+  struct PendingLoad {
+    /// @brief The result of the worker thread.
+    std::future<TDecoded> decoded;
+    /// @brief Fulfilled once the resource is cached.
+    std::promise<TResource*> promise;
+    /// @brief The future handed out to the callers, bound to promise.
+    std::shared_future<TResource*> result;
+  };
+
+  /// @brief Loads a texture on a thread other than the main thread. The image is decoded on the calling thread, rather than on a
+  ///        worker that may be busy with the caller's own task, and uploaded by the next FinalizePendingLoads, which the call waits for.
+  /// @param full_path The absolute path of the texture file.
+  /// @return A reference to the cached texture.
+  sf::Texture& LoadTextureOffMainThread(const std::filesystem::path& full_path);
+
+  /// @brief Returns the absolute path of a resource file.
+  /// @param filename The relative path to the resource file.
+  /// @return The absolute path of the file inside the resources directory.
+  static std::filesystem::path GetFullPath(
+      const std::filesystem::path& filename);
+
   /// @brief The prefix for all resource file paths.
   static constexpr std::string_view kPrefix_ = "resources/";
 
+  /// @brief The pool decoding the asynchronous loads. Never null after construction.
+  ThreadPool* thread_pool_ = nullptr;
+  /// @brief The thread constructing the resource manager, the only one creating OpenGL resources.
+  std::thread::id main_thread_id_;
+  /// @brief Protects the caches and the pending loads. Never held while decoding or uploading a resource.
+  std::mutex mutex_;
+
   /// @brief Cache for loaded textures, mapping file paths to SFML Textures.
   std::unordered_map<std::filesystem::path, sf::Texture> textures_;
   /// @brief Cache for loaded sound buffers, mapping file paths to SFML SoundBuffers.
   std::unordered_map<std::filesystem::path, sf::SoundBuffer> sound_buffers_;
   /// @brief Cache for loaded fonts, mapping file paths to SFML Fonts.
   std::unordered_map<std::filesystem::path, sf::Font> fonts_;
+
+  /// @brief Asynchronous texture loads, decoded to images by the workers and uploaded on the main thread.
+  std::unordered_map<std::filesystem::path, PendingLoad<sf::Texture, sf::Image>>
+      pending_textures_;
+  /// @brief Asynchronous sound buffer loads, fully decoded by the workers.
+  std::unordered_map<std::filesystem::path,
+                     PendingLoad<sf::SoundBuffer, sf::SoundBuffer>>
+      pending_sound_buffers_;
+  /// @brief Asynchronous font loads, fully opened by the workers.
+  std::unordered_map<std::filesystem::path, PendingLoad<sf::Font, sf::Font>>
+      pending_fonts_;
 };
 
 }  // namespace ng
\ No newline at end of file
@@ -1,9 +1,15 @@
 #include "scene.h"
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
@@ -12,13 +18,30 @@
 #include "camera_manager.h"
 #include "layer.h"
 #include "node.h"
+#include "node_arena.h"
+#include "node_handle.h"
 #include "physics.h"
+#include "profiler.h"
+#include "sprite_batch.h"
 
 namespace ng {
 
-Scene::Scene(App* app) : root_(std::make_unique<Node>(app)) {
+/// @brief Returns a new scene identifier, distinct from all the previously returned ones and from 0. Thread-safe, as scenes can be built on worker threads.
+/// @return The new identifier.
+static uint32_t NextSceneId() {
+  static std::atomic<uint32_t> next_id = 1;
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+Scene::Scene(App* app, PhysicsBroadphase broadphase)
+    : id_(NextSceneId()), physics_(broadphase) {
   assert(app);
+  // The root records the arena, so every node made through it is allocated
+  // from the arena too.
+  NodeArena::Scope arena_scope(&node_arena_);
+  root_ = std::make_unique<Node>(app);
   root_->SetName("SceneRoot");
+  root_->SetTickEnabled(false);
   // Render all layers by default on the root node.
   root_->SetLayer(static_cast<Layer>(~0ULL));
 }
@@ -43,26 +66,78 @@ Physics& Scene::GetMutablePhysics() {
   return physics_;
 }
 
-void Scene::AddChild(std::unique_ptr<Node> new_child) {
-  root_->AddChild(std::move(new_child));
+SpriteBatch& Scene::GetSpriteBatch() {
+  return sprite_batch_;
+}
+
+const NodeArena& Scene::GetNodeArena() const {
+  return node_arena_;
 }
 
-bool Scene::IsValid(const Node* node) const {
-  return scene_nodes_.contains(node);
+bool Scene::IsValid(NodeHandle handle) const {
+  return handle.scene_id == id_ && handle.index < node_slots_.size() &&
+         node_slots_[handle.index].generation == handle.generation;
+}
+
+Node* Scene::GetNode(NodeHandle handle) const {
+  if (!IsValid(handle)) {
+    return nullptr;
+  }
+
+  return node_slots_[handle.index].node;
 }
 
 void Scene::InternalOnAdd() {
   root_->InternalOnAdd(this);
+  // The root is added directly, so its children have to be queued explicitly.
+  QueueStructureChanges(root_.get());
 }
 
 void Scene::InternalUpdate() {
-  root_->InternalUpdate();
+  // Changes queued while applying these, for example by OnAdd or OnDestroy,
+  // are applied in the next frame.
+  auto prev_frame_structure_changes = std::move(structure_changes_);
+  for (NodeHandle handle : prev_frame_structure_changes) {
+    Node* node = GetNode(handle);
+    if (node != nullptr) {
+      node->ApplyStructureChanges();
+    }
+  }
+
+  // Nodes that start ticking during this loop are appended past tick_count,
+  // so they tick for the first time in the next frame.
+  size_t tick_count = tick_list_.size();
+  for (size_t i = 0; i < tick_count; ++i) {
+    Node* node = tick_list_[i];
+    if (node == nullptr) {
+      continue;
+    }
+
+    NG_PROFILE_TYPE_SCOPE("Update", *node);
+    node->Update();
+  }
+
+  physics_.UpdateContacts();
+
+  if (empty_tick_slot_count_ > 0 &&
+      empty_tick_slot_count_ * 2 >= tick_list_.size()) {
+    CompactTickList();
+  }
 }
 
 void Scene::InternalDraw(sf::RenderTarget& target) {
+  if (is_draw_list_dirty_) {
+    NG_PROFILE_SCOPE("Draw", "Scene::BuildDrawList");
+    BuildDrawList();
+  }
+
   for (const Camera* camera : camera_manager_.GetCameras()) {
     target.setView(camera->GetView());
-    root_->InternalDraw(*camera, target);
+    DrawBuckets(*camera, target);
+    {
+      NG_PROFILE_SCOPE("Draw", "SpriteBatch::Flush");
+      sprite_batch_.Flush(target);
+    }
   }
 }
 
@@ -70,14 +145,161 @@ void Scene::InternalOnDestroy() {
   root_->InternalOnDestroy();
 }
 
-void Scene::RegisterNode(const Node* node) {
+NodeHandle Scene::RegisterNode(Node* node) {
   assert(node);
-  scene_nodes_.insert(node);
+  uint32_t index = 0;
+  if (free_node_slots_.empty()) {
+    assert(node_slots_.size() < NodeHandle::kInvalidIndex);
+    index = static_cast<uint32_t>(node_slots_.size());
+    node_slots_.emplace_back();
+  } else {
+    index = free_node_slots_.back();
+    free_node_slots_.pop_back();
+  }
+
+  NodeSlot& slot = node_slots_[index];
+  slot.node = node;
+  return {.scene_id = id_, .index = index, .generation = slot.generation};
+}
+
+void Scene::UnregisterNode(NodeHandle handle) {
+  assert(IsValid(handle));
+  NodeSlot& slot = node_slots_[handle.index];
+  slot.node = nullptr;
+  ++slot.generation;
+  free_node_slots_.push_back(handle.index);
+}
+
+void Scene::RegisterTick(Node* node) {
+  assert(node && node->tick_index_ == Node::kInvalidTickIndex);
+  node->tick_index_ = tick_list_.size();
+  tick_list_.push_back(node);
+}
+
+void Scene::UnregisterTick(Node* node) {
+  assert(node && tick_list_[node->tick_index_] == node);
+  tick_list_[node->tick_index_] = nullptr;
+  node->tick_index_ = Node::kInvalidTickIndex;
+  ++empty_tick_slot_count_;
+}
+
+void Scene::CompactTickList() {
+  size_t next_index = 0;
+  for (Node* node : tick_list_) {
+    if (node == nullptr) {
+      continue;
+    }
+
+    node->tick_index_ = next_index;
+    tick_list_[next_index] = node;
+    ++next_index;
+  }
+
+  tick_list_.resize(next_index);
+  empty_tick_slot_count_ = 0;
+}
+
+void Scene::InvalidateDrawList() {
+  is_draw_list_dirty_ = true;
+}
+
+void Scene::BuildDrawList() {
+  for (DrawBucket& bucket : draw_buckets_) {
+    bucket.entries.clear();
+  }
+
+  // The root itself has nothing to draw.
+  size_t draw_index = 0;
+  uint64_t root_layers = std::to_underlying(root_->GetLayer());
+  for (auto& child : root_->children_) {
+    if (child != nullptr) {
+      AppendToDrawList(child.get(), root_layers, draw_index);
+    }
+  }
+
+  is_draw_list_dirty_ = false;
+}
+
+void Scene::AppendToDrawList(Node* node, uint64_t parent_layers,
+                             size_t& draw_index) {
+  // A camera skips the whole subtree of a node it does not render, so the
+  // layers of a node are narrowed by those of its ancestors.
+  uint64_t layers = parent_layers & std::to_underlying(node->GetLayer());
+  if (layers == 0) {
+    return;
+  }
+
+  auto bucket = std::ranges::find(draw_buckets_, layers, &DrawBucket::layers);
+  if (bucket == draw_buckets_.end()) {
+    bucket = draw_buckets_.insert(
+        bucket, DrawBucket{.layers = layers, .entries = {}});
+  }
+  bucket->entries.push_back({.draw_index = draw_index, .node = node});
+  ++draw_index;
+
+  for (auto& child : node->children_) {
+    if (child != nullptr) {
+      AppendToDrawList(child.get(), layers, draw_index);
+    }
+  }
+}
+
+void Scene::DrawBuckets(const Camera& camera, sf::RenderTarget& target) {
+  uint64_t camera_layers = std::to_underlying(camera.GetRenderLayers());
+  // The view covers the [-1, 1] range in normalized device coordinates.
+  sf::FloatRect view_bounds =
+      camera.GetView().getInverseTransform().transformRect(
+          sf::FloatRect({-1.F, -1.F}, {2.F, 2.F}));
+  draw_cursors_.clear();
+  for (const DrawBucket& bucket : draw_buckets_) {
+    if ((bucket.layers & camera_layers) != 0 && !bucket.entries.empty()) {
+      draw_cursors_.push_back({.bucket = &bucket, .next = 0});
+    }
+  }
+
+  // Merges the buckets back into preorder. There are only a handful of
+  // distinct layer sets, so a linear scan for the smallest index is enough.
+  while (true) {
+    DrawCursor* next_cursor = nullptr;
+    size_t next_draw_index = 0;
+    for (DrawCursor& cursor : draw_cursors_) {
+      if (cursor.next == cursor.bucket->entries.size()) {
+        continue;
+      }
+
+      size_t draw_index = cursor.bucket->entries[cursor.next].draw_index;
+      if (next_cursor == nullptr || draw_index < next_draw_index) {
+        next_cursor = &cursor;
+        next_draw_index = draw_index;
+      }
+    }
+
+    if (next_cursor == nullptr) {
+      break;
+    }
+
+    Node* node = next_cursor->bucket->entries[next_cursor->next].node;
+    ++next_cursor->next;
+
+    // Nodes without bounds are always drawn.
+    const std::optional<sf::FloatRect>& bounds = node->GetWorldBounds();
+    if (bounds.has_value() && !bounds->findIntersection(view_bounds)) {
+      continue;
+    }
+
+    // The sprites batched so far lie under the nodes drawn directly.
+    if (node->IsDrawnDirectly()) {
+      sprite_batch_.Flush(target);
+    }
+
+    NG_PROFILE_TYPE_SCOPE("Draw", *node);
+    node->Draw(target);
+  }
 }
 
-void Scene::UnregisterNode(const Node* node) {
+void Scene::QueueStructureChanges(Node* node) {
   assert(node);
-  scene_nodes_.erase(node);
+  structure_changes_.push_back(node->GetHandle());
 }
 
 void Scene::OnWindowResize(sf::Vector2u size) {
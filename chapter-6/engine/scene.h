@@ -1,14 +1,20 @@
 #pragma once
 
 #include <SFML/Graphics/RenderTarget.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
-#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "camera_manager.h"
 #include "derived.h"
 #include "node.h"
+#include "node_arena.h"
+#include "node_handle.h"
 #include "physics.h"
+#include "sprite_batch.h"
 
 namespace ng {
 
@@ -20,12 +26,16 @@ class Scene {
   // App needs to be able to call InternalOnAdd, InternalUpdate,
   // InternalDraw, InternalOnDestroy, and OnWindowResize.
   friend class App;
-  // Node needs to be able to call RegisterNode, and UnregisterNode.
+  // Node needs to be able to call RegisterNode, UnregisterNode, RegisterTick,
+  // UnregisterTick, QueueStructureChanges, and InvalidateDrawList, and to
+  // allocate its children from node_arena_.
   friend class Node;
 
   /// @brief Constructs a Scene associated with a specific App instance.
   /// @param app A pointer to the App instance this scene belongs to. This pointer must not be null.
-  explicit Scene(App* app);
+  /// @param broadphase The broadphase the physics world of the scene finds collision candidates with.
+  explicit Scene(
+      App* app, PhysicsBroadphase broadphase = PhysicsBroadphase::kSpatialHash);
 
   /// @brief Returns the name of the scene.
   /// @return A constant reference to the scene's name.
@@ -47,11 +57,21 @@ class Scene {
   /// @return A mutable reference to the Physics engine.
   [[nodiscard]] Physics& GetMutablePhysics();
 
+  /// @brief Returns a reference to the SpriteBatch of the scene. Sprites drawn through it are rendered before the next node drawn directly, or at the end of the camera pass.
+  ///        Nodes drawing through it should declare so with Node::SetDrawnDirectly, so that consecutive batched nodes share draw calls.
+  /// @return A reference to the SpriteBatch.
+  [[nodiscard]] SpriteBatch& GetSpriteBatch();
+
   /// @brief Adds a new child node to the root of the scene. Ownership of the node is transferred to the scene.
+  /// @tparam T The concrete type of the Node to add, must derive from Node. See Node::AddChild.
   /// @param new_child A unique pointer to the Node to be added. This pointer must not be null.
-  void AddChild(std::unique_ptr<Node> new_child);
+  template <Derived<Node> T>
+  void AddChild(std::unique_ptr<T> new_child) {
+    root_->AddChild(std::move(new_child));
+  }
 
   /// @brief Creates and adds a new child node of the specified type to the root of the scene.
+  ///        The node and its descendants are allocated from the NodeArena of the scene.
   /// @tparam T The type of the Node to create, must derive from Node.
   /// @tparam Args The constructor arguments for the Node type T.
   /// @param args The arguments to forward to the constructor of T.
@@ -61,28 +81,67 @@ class Scene {
     return root_->MakeChild<T>(std::forward<Args>(args)...);
   }
 
-  /// @brief Checks if a given Node pointer is currently registered within this scene.
-  /// @param node A pointer to the Node to check. Can be null (no-op).
-  /// @return True if the Node is valid and belongs to this scene, false otherwise.
-  bool IsValid(const Node* node) const;
+  /// @brief Returns the arena the nodes of the scene are allocated from.
+  /// @return A constant reference to the NodeArena.
+  [[nodiscard]] const NodeArena& GetNodeArena() const;
+
+  /// @brief Checks if the node referred to by a handle is still registered within this scene.
+  /// @param handle The handle to check. Can be invalid or issued by another scene.
+  /// @return True if the node is alive and belongs to this scene, false otherwise.
+  [[nodiscard]] bool IsValid(NodeHandle handle) const;
+
+  /// @brief Returns the node referred to by a handle.
+  /// @param handle The handle of the node. Can be invalid.
+  /// @return A pointer to the node, or null if the handle is no longer valid.
+  [[nodiscard]] Node* GetNode(NodeHandle handle) const;
 
  private:
   /// @brief Internal method called when the scene is added to the App. Notifies the root node.
   void InternalOnAdd();
-  /// @brief Internal method called during the game loop to update the scene's logic. Updates the root node.
+  /// @brief Internal method called during the game loop to update the scene's logic.
+  ///        Applies the structure changes queued in the previous frame, calls Update on every ticking node, in the order they started ticking, then dispatches the collision callbacks.
   void InternalUpdate();
-  /// @brief Internal method called during the game loop to draw the scene. Draws the root node through each camera.
+  /// @brief Internal method called during the game loop to draw the scene. Draws the nodes through each camera, in the order of the scene graph.
+  ///        The draw lists are rebuilt first if the scene graph or a layer changed since the last frame.
   /// @param target The SFML RenderTarget to draw to.
   void InternalDraw(sf::RenderTarget& target);
   /// @brief Internal method called when the scene is about to be destroyed or unloaded. Notifies the root node.
   void InternalOnDestroy();
 
-  /// @brief Registers a Node with the scene, allowing for quick validation. Called by Node during its addition to the hierarchy.
+  /// @brief Registers a Node with the scene, allocating a slot for it. Called by Node during its addition to the hierarchy.
   /// @param node A pointer to the Node being registered. This pointer must not be null.
-  void RegisterNode(const Node* node);
-  /// @brief Unregisters a Node from the scene. Called by Node during its removal from the hierarchy.
-  /// @param node A pointer to the Node being unregistered. This pointer must not be null.
-  void UnregisterNode(const Node* node);
+  /// @return The handle of the node.
+  NodeHandle RegisterNode(Node* node);
+  /// @brief Unregisters a Node from the scene, invalidating all its handles. Called by Node during its removal from the hierarchy.
+  /// @param handle The handle of the Node being unregistered. Must be valid.
+  void UnregisterNode(NodeHandle handle);
+
+  /// @brief Appends a Node to the tick list. Called by Node when it is added with ticking enabled, or when ticking is enabled.
+  /// @param node A pointer to the Node to tick. This pointer must not be null and the Node must not be in the tick list.
+  void RegisterTick(Node* node);
+  /// @brief Removes a Node from the tick list, leaving its slot empty until the next compaction.
+  /// @param node A pointer to the Node to stop ticking. This pointer must not be null and the Node must be in the tick list.
+  void UnregisterTick(Node* node);
+  /// @brief Removes the empty slots of the tick list, preserving the order of the remaining nodes and updating their indices.
+  void CompactTickList();
+
+  /// @brief Marks the draw lists as stale, so that they are rebuilt before the next draw.
+  void InvalidateDrawList();
+  /// @brief Rebuilds the draw buckets from the scene graph in a single traversal.
+  void BuildDrawList();
+  /// @brief Appends a subtree to the draw buckets in preorder.
+  /// @param node A pointer to the root of the subtree. This pointer must not be null.
+  /// @param parent_layers The layers shared by all the ancestors of the node.
+  /// @param draw_index The preorder index of the next drawn node, incremented for each node appended.
+  void AppendToDrawList(Node* node, uint64_t parent_layers, size_t& draw_index);
+  /// @brief Draws the nodes of every bucket sharing a layer with a camera, merged back into preorder.
+  /// @param camera The Camera used for rendering.
+  /// @param target The SFML RenderTarget to draw to.
+  void DrawBuckets(const Camera& camera, sf::RenderTarget& target);
+
+  /// @brief Schedules the queued children of a Node to be erased and added at the beginning of the next frame.
+  /// @param node A pointer to the Node whose children changed. This pointer must not be null.
+  void QueueStructureChanges(Node* node);
 
   /// @brief Called when the game window is resized. Notifies the CameraManager to update its cameras.
   /// @param new_size The new size of the window.
@@ -90,14 +149,73 @@ class Scene {
 
   // The name of the scene.
   std::string name_;
+  // Identifies the scene in the handles it issues. Unique among the scenes of the program.
+  uint32_t id_;
 
   // Manages the cameras within the scene.
   CameraManager camera_manager_;
   // Handles the physics simulation for the scene.
   Physics physics_;
-
-  // A set containing all Nodes currently registered in the scene for fast lookup.
-  std::unordered_set<const Node*> scene_nodes_;
+  // Batches the sprites drawn during a camera pass into one draw call per texture.
+  SpriteBatch sprite_batch_;
+
+  /// @brief A slot of the node table.
+  struct NodeSlot {
+    // The node occupying the slot, null if the slot is free.
+    Node* node = nullptr;
+    // Incremented every time the slot is freed, invalidating the handles to its previous node.
+    uint32_t generation = 0;
+  };
+
+  // The slots of all the Nodes registered in the scene, indexed by NodeHandle::index.
+  std::vector<NodeSlot> node_slots_;
+  // The indices of the free slots of node_slots_, reused last in first out.
+  std::vector<uint32_t> free_node_slots_;
+
+  // The nodes whose Update is called every tick, in the order they started ticking.
+  // The slots of nodes that stopped ticking are null until the next compaction.
+  std::vector<Node*> tick_list_;
+  // The number of null slots in tick_list_.
+  size_t empty_tick_slot_count_ = 0;
+  // The nodes with children to erase or add at the beginning of the next frame, in order of scheduling.
+  // Handles rather than pointers, since a node can be destroyed along with an ancestor before its changes are applied.
+  std::vector<NodeHandle> structure_changes_;
+
+  /// @brief A node to draw, with its position in the preorder of the scene graph.
+  struct DrawEntry {
+    // The preorder index of the node among the drawn nodes.
+    size_t draw_index = 0;
+    // The node to draw. Never null.
+    Node* node = nullptr;
+  };
+
+  /// @brief The nodes drawn by the cameras rendering any of a set of layers.
+  struct DrawBucket {
+    // The layers shared by the nodes of the bucket and all their ancestors.
+    uint64_t layers = 0;
+    // The nodes of the bucket, in preorder.
+    std::vector<DrawEntry> entries;
+  };
+
+  /// @brief The next entry to draw from a bucket during the merge of a camera pass.
+  struct DrawCursor {
+    // The bucket being drawn. Never null.
+    const DrawBucket* bucket = nullptr;
+    // The index of the next entry of the bucket to draw.
+    size_t next = 0;
+  };
+
+  // The nodes to draw, bucketed by the layers they are drawn on. Buckets are
+  // kept when they become empty so that their memory is reused.
+  std::vector<DrawBucket> draw_buckets_;
+  // The cursors of the buckets matching the current camera. Kept to reuse its memory.
+  std::vector<DrawCursor> draw_cursors_;
+  // Flag indicating if the draw buckets must be rebuilt before the next draw.
+  bool is_draw_list_dirty_ = true;
+
+  // The arena the nodes of the scene are allocated from. Declared before root_
+  // so that it outlives every node and releases its chunks after them.
+  NodeArena node_arena_;
 
   // The root node of the scene graph. All entities in the scene are descendants of this node.
   // Ownership is managed by the Scene. This pointer is never null after construction.
@@ -0,0 +1,159 @@
+#include "spatial_hash.h"
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "collider.h"
+#include "collision_layer.h"
+
+namespace ng {
+
+SpatialHash::SpatialHash(float cell_size) : cell_size_(cell_size) {
+  assert(cell_size > 0);
+}
+
+void SpatialHash::Insert(const Collider* collider) {
+  assert(collider);
+  [[maybe_unused]] auto [it, inserted] = proxies_.insert(
+      {collider, Proxy{.collider = collider,
+                       .cells = ToCellRange(collider->GetGlobalBounds()),
+                       .category = collider->GetCollisionCategory()}});
+  assert(inserted);
+  AddToCells(&it->second);
+}
+
+void SpatialHash::Remove(const Collider* collider) {
+  assert(collider);
+  auto it = proxies_.find(collider);
+  if (it == proxies_.end()) {
+    return;
+  }
+
+  Proxy* proxy = &it->second;
+  RemoveFromCells(proxy);
+  if (proxy->is_dirty) {
+    std::erase(dirty_proxies_, proxy);
+  }
+  proxies_.erase(it);
+}
+
+void SpatialHash::MarkDirty(const Collider* collider) {
+  assert(collider);
+  auto it = proxies_.find(collider);
+  if (it == proxies_.end() || it->second.is_dirty) {
+    return;
+  }
+
+  it->second.is_dirty = true;
+  dirty_proxies_.push_back(&it->second);
+}
+
+void SpatialHash::UpdateCategory(const Collider* collider) {
+  assert(collider);
+  auto it = proxies_.find(collider);
+  if (it == proxies_.end()) {
+    return;
+  }
+
+  Proxy* proxy = &it->second;
+  RemoveFromCells(proxy);
+  proxy->category = collider->GetCollisionCategory();
+  AddToCells(proxy);
+}
+
+void SpatialHash::Refresh() {
+  for (Proxy* proxy : dirty_proxies_) {
+    proxy->is_dirty = false;
+
+    CellRange cells = ToCellRange(proxy->collider->GetGlobalBounds());
+    // Most moves stay within the same cells, leaving the grid untouched.
+    if (cells == proxy->cells) {
+      continue;
+    }
+
+    RemoveFromCells(proxy);
+    proxy->cells = cells;
+    AddToCells(proxy);
+  }
+
+  dirty_proxies_.clear();
+}
+
+void SpatialHash::Query(sf::FloatRect bounds, CollisionLayer mask,
+                        std::vector<const Collider*>& out) const {
+  ++query_stamp_;
+
+  CellRange range = ToCellRange(bounds);
+  for (int32_t y = range.min.y; y <= range.max.y; ++y) {
+    for (int32_t x = range.min.x; x <= range.max.x; ++x) {
+      auto it = cells_.find(ToKey({x, y}));
+      if (it == cells_.end() || !Intersects(it->second.categories, mask)) {
+        continue;
+      }
+
+      for (const Proxy* proxy : it->second.proxies) {
+        // Colliders spanning multiple cells are reported only once.
+        if (proxy->query_stamp == query_stamp_ ||
+            !Intersects(proxy->category, mask)) {
+          continue;
+        }
+
+        proxy->query_stamp = query_stamp_;
+        out.push_back(proxy->collider);
+      }
+    }
+  }
+}
+
+SpatialHash::CellRange SpatialHash::ToCellRange(sf::FloatRect bounds) const {
+  sf::Vector2f min = bounds.position;
+  sf::Vector2f max = bounds.position + bounds.size;
+  return {
+      .min = {static_cast<int32_t>(std::floor(min.x / cell_size_)),
+              static_cast<int32_t>(std::floor(min.y / cell_size_))},
+      .max = {static_cast<int32_t>(std::floor(max.x / cell_size_)),
+              static_cast<int32_t>(std::floor(max.y / cell_size_))},
+  };
+}
+
+uint64_t SpatialHash::ToKey(sf::Vector2i cell) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(cell.x)) << 32U) |
+         static_cast<uint64_t>(static_cast<uint32_t>(cell.y));
+}
+
+void SpatialHash::AddToCells(Proxy* proxy) {
+  for (int32_t y = proxy->cells.min.y; y <= proxy->cells.max.y; ++y) {
+    for (int32_t x = proxy->cells.min.x; x <= proxy->cells.max.x; ++x) {
+      Cell& cell = cells_[ToKey({x, y})];
+      cell.proxies.push_back(proxy);
+      cell.categories = cell.categories | proxy->category;
+    }
+  }
+}
+
+void SpatialHash::RemoveFromCells(Proxy* proxy) {
+  for (int32_t y = proxy->cells.min.y; y <= proxy->cells.max.y; ++y) {
+    for (int32_t x = proxy->cells.min.x; x <= proxy->cells.max.x; ++x) {
+      Cell& cell = cells_.at(ToKey({x, y}));
+      // The order inside a cell is irrelevant, so swap and pop.
+      auto it = std::ranges::find(cell.proxies, proxy);
+      assert(it != cell.proxies.end());
+      *it = cell.proxies.back();
+      cell.proxies.pop_back();
+
+      // Categories cannot be subtracted from a union, so rebuild it from the
+      // remaining proxies. Cells only hold a handful of colliders.
+      cell.categories = CollisionLayer::kNone;
+      for (const Proxy* other : cell.proxies) {
+        cell.categories = cell.categories | other->category;
+      }
+    }
+  }
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "broadphase.h"
+#include "collision_layer.h"
+
+namespace ng {
+
+class Collider;
+
+/// @brief A uniform grid broadphase that buckets colliders by the cells overlapped by their world bounds.
+///        Cells are stored sparsely in a hash map, so the grid has no fixed extent.
+class SpatialHash : public Broadphase {
+ public:
+  /// @brief Constructs an empty SpatialHash.
+  /// @param cell_size The side length of a grid cell in world units. Must be positive.
+  explicit SpatialHash(float cell_size);
+
+  /// @brief Inserts a collider into the grid using its current global bounds and collision category.
+  /// @param collider A pointer to the Collider to insert. This pointer must not be null and the Collider must not be already inserted.
+  void Insert(const Collider* collider) override;
+
+  /// @brief Removes a collider from the grid. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider to remove. This pointer must not be null.
+  void Remove(const Collider* collider) override;
+
+  /// @brief Marks the bounds of a collider as stale. Its cells are recomputed by the next call to Refresh. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider whose global transform changed. This pointer must not be null.
+  void MarkDirty(const Collider* collider) override;
+
+  /// @brief Updates the collision category a collider is indexed by. No-op if the collider is not inserted.
+  /// @param collider A pointer to the Collider whose category changed. This pointer must not be null.
+  void UpdateCategory(const Collider* collider) override;
+
+  /// @brief Recomputes the cells of every collider marked dirty since the last refresh.
+  void Refresh() override;
+
+  /// @brief Appends to `out` every collider sharing at least one cell with the given bounds and whose category shares a layer with the mask.
+  ///        Each collider is appended at most once. Cells without any collider of the mask are skipped as a whole.
+  ///        Refresh must be called beforehand for the results to reflect the latest transforms.
+  /// @param bounds The world space bounds to query.
+  /// @param mask The collision layers of the colliders to report.
+  /// @param out The vector the candidate colliders are appended to.
+  void Query(sf::FloatRect bounds, CollisionLayer mask,
+             std::vector<const Collider*>& out) const override;
+
+ private:
+  /// @brief An inclusive range of grid cells.
+  struct CellRange {
+    sf::Vector2i min;
+    sf::Vector2i max;
+
+    bool operator==(const CellRange& other) const = default;
+  };
+
+  /// @brief The per-collider bookkeeping of the grid.
+  struct Proxy {
+    // The collider this proxy refers to. Never null.
+    const Collider* collider = nullptr;
+    // The cells the collider is currently stored in.
+    CellRange cells;
+    // The collision category of the collider, copied to avoid dereferencing it during queries.
+    CollisionLayer category = CollisionLayer::kNone;
+    // Flag indicating if the proxy is waiting in the dirty list.
+    bool is_dirty = false;
+    // The last query that visited this proxy, used to report each collider once per query.
+    mutable uint64_t query_stamp = 0;
+  };
+
+  /// @brief A cell of the grid.
+  struct Cell {
+    // The proxies of the colliders overlapping the cell, in no particular order.
+    std::vector<Proxy*> proxies;
+    // The union of the categories of the proxies, used to skip the cell during queries.
+    CollisionLayer categories = CollisionLayer::kNone;
+  };
+
+  /// @brief Converts world space bounds to the range of cells they overlap.
+  /// @param bounds The world space bounds to convert.
+  /// @return The inclusive range of overlapped cells.
+  [[nodiscard]] CellRange ToCellRange(sf::FloatRect bounds) const;
+
+  /// @brief Packs cell coordinates into a single hash map key.
+  /// @param cell The cell coordinates.
+  /// @return The key of the cell.
+  [[nodiscard]] static uint64_t ToKey(sf::Vector2i cell);
+
+  /// @brief Adds a proxy to every cell of its range.
+  /// @param proxy The proxy to add.
+  void AddToCells(Proxy* proxy);
+
+  /// @brief Removes a proxy from every cell of its range, recomputing the categories of the cells.
+  /// @param proxy The proxy to remove.
+  void RemoveFromCells(Proxy* proxy);
+
+  // The side length of a grid cell in world units.
+  float cell_size_ = 0;
+  // The proxies of all the inserted colliders. The hash map guarantees stable addresses for its values.
+  std::unordered_map<const Collider*, Proxy> proxies_;
+  // The occupied cells, indexed by their packed coordinates. Emptied cells are kept to reuse their storage.
+  std::unordered_map<uint64_t, Cell> cells_;
+  // The proxies whose cells have to be recomputed.
+  std::vector<Proxy*> dirty_proxies_;
+  // The identifier of the last query, incremented on each query.
+  mutable uint64_t query_stamp_ = 0;
+};
+
+}  // namespace ng
\ No newline at end of file
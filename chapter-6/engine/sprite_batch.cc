@@ -0,0 +1,63 @@
+#include "sprite_batch.h"
+
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cmath>
+
+namespace ng {
+
+void SpriteBatch::Draw(const sf::Sprite& sprite,
+                       const sf::Transform& transform) {
+  const sf::Texture* texture = &sprite.getTexture();
+  auto [it, inserted] = batch_indices_.try_emplace(texture, batches_.size());
+  if (inserted) {
+    batches_.push_back(Batch{.texture = texture, .vertices = {}});
+  }
+  Batch& batch = batches_[it->second];
+
+  // Same geometry as sf::Sprite: a negative texture rect size flips the
+  // texture coordinates but not the quad.
+  sf::FloatRect rect(sprite.getTextureRect());
+  sf::Vector2f size(std::abs(rect.size.x), std::abs(rect.size.y));
+  sf::Transform combined = transform * sprite.getTransform();
+  sf::Color color = sprite.getColor();
+
+  sf::Vertex left_top{combined.transformPoint({0.F, 0.F}), color,
+                      rect.position};
+  sf::Vertex left_bottom{combined.transformPoint({0.F, size.y}), color,
+                         rect.position + sf::Vector2f(0.F, rect.size.y)};
+  sf::Vertex right_top{combined.transformPoint({size.x, 0.F}), color,
+                       rect.position + sf::Vector2f(rect.size.x, 0.F)};
+  sf::Vertex right_bottom{combined.transformPoint(size), color,
+                          rect.position + rect.size};
+
+  batch.vertices.push_back(left_top);
+  batch.vertices.push_back(left_bottom);
+  batch.vertices.push_back(right_top);
+  batch.vertices.push_back(right_top);
+  batch.vertices.push_back(left_bottom);
+  batch.vertices.push_back(right_bottom);
+}
+
+void SpriteBatch::Flush(sf::RenderTarget& target) {
+  for (Batch& batch : batches_) {
+    if (batch.vertices.empty()) {
+      continue;
+    }
+
+    sf::RenderStates state;
+    state.texture = batch.texture;
+    target.draw(batch.vertices.data(), batch.vertices.size(),
+                sf::PrimitiveType::Triangles, state);
+    batch.vertices.clear();
+  }
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace ng {
+
+/// @brief Accumulates sprites into one vertex array per texture, so that all the sprites sharing a texture are rendered with a single draw call.
+///        Batches are drawn in the order their texture was first used, so sprites using different textures should not rely on overlapping each other in node order.
+class SpriteBatch {
+ public:
+  /// @brief Appends the quad of a sprite to the batch of its texture. Nothing is rendered until the next Flush.
+  /// @param sprite The sprite to draw. Its texture must outlive the next Flush.
+  /// @param transform The transform to apply on top of the sprite's own transform, usually the global transform of the drawing node.
+  void Draw(const sf::Sprite& sprite, const sf::Transform& transform);
+
+  /// @brief Renders every non-empty batch with one draw call per texture and empties the batches, keeping their memory for the next frame.
+  /// @param target The SFML RenderTarget to draw to.
+  void Flush(sf::RenderTarget& target);
+
+ private:
+  /// @brief The vertices of all the sprites sharing a texture.
+  struct Batch {
+    // The texture shared by all the vertices of the batch. Never null.
+    const sf::Texture* texture = nullptr;
+    // The vertices of the batch, six per sprite.
+    std::vector<sf::Vertex> vertices;
+  };
+
+  // The batches, in the order their texture was first drawn.
+  std::vector<Batch> batches_;
+  // The index in batches_ of the batch of each texture.
+  std::unordered_map<const sf::Texture*, size_t> batch_indices_;
+};
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "sweep.h"
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+#include "collider.h"
+
+namespace ng {
+
+namespace {
+
+/// @brief Finds where a moving point enters an axis-aligned box it starts outside of.
+/// @param origin The point before the move.
+/// @param displacement The displacement of the point.
+/// @param min The top left corner of the box.
+/// @param max The bottom right corner of the box.
+/// @return The time and normal of the entry, or nullopt if the point does not reach the box.
+std::optional<SweepContact> SweepPointBox(sf::Vector2f origin,
+                                          sf::Vector2f displacement,
+                                          sf::Vector2f min, sf::Vector2f max) {
+  // The slab test: the point is in the box while it is between both pairs of
+  // sides, so it enters at the latest of its entries into the two slabs.
+  float enter = 0;
+  float exit = 1;
+  sf::Vector2f normal;
+  for (bool is_x : {true, false}) {
+    float position = is_x ? origin.x : origin.y;
+    float delta = is_x ? displacement.x : displacement.y;
+    float low = is_x ? min.x : min.y;
+    float high = is_x ? max.x : max.y;
+    if (delta == 0) {
+      if (position < low || position > high) {
+        return std::nullopt;
+      }
+      continue;
+    }
+
+    float near_time = ((delta > 0 ? low : high) - position) / delta;
+    float far_time = ((delta > 0 ? high : low) - position) / delta;
+    if (near_time > enter) {
+      enter = near_time;
+      normal = is_x ? sf::Vector2f(delta > 0 ? -1.F : 1.F, 0.F)
+                    : sf::Vector2f(0.F, delta > 0 ? -1.F : 1.F);
+    }
+    exit = std::min(exit, far_time);
+  }
+  if (enter > exit) {
+    return std::nullopt;
+  }
+
+  return SweepContact{.time = enter, .normal = normal};
+}
+
+/// @brief Finds where a moving point enters a circle it starts outside of.
+/// @param origin The point before the move.
+/// @param displacement The displacement of the point. Must not be zero.
+/// @param center The center of the circle.
+/// @param radius The radius of the circle.
+/// @return The time and normal of the entry, or nullopt if the point does not reach the circle.
+std::optional<SweepContact> SweepPointCircle(sf::Vector2f origin,
+                                             sf::Vector2f displacement,
+                                             sf::Vector2f center,
+                                             float radius) {
+  // Solves |offset + displacement * t| = radius for its smallest root.
+  sf::Vector2f offset = origin - center;
+  float a = displacement.dot(displacement);
+  float b = offset.dot(displacement);
+  float c = offset.dot(offset) - (radius * radius);
+  float discriminant = (b * b) - (a * c);
+  if (b >= 0 || discriminant < 0) {
+    return std::nullopt;
+  }
+
+  float time = (-b - std::sqrt(discriminant)) / a;
+  if (time > 1) {
+    return std::nullopt;
+  }
+
+  sf::Vector2f normal = offset + (displacement * time);
+  return SweepContact{.time = std::max(time, 0.F),
+                      .normal = normal / normal.length()};
+}
+
+}  // namespace
+
+std::optional<SweepContact> SweepShape(const ColliderShape& shape,
+                                       sf::Vector2f displacement,
+                                       const ColliderShape& target) {
+  // Sweeping two shapes is sweeping the center of the first against their
+  // Minkowski sum: a rectangle with rounded corners of the combined radius.
+  sf::Vector2f center = target.center;
+  sf::Vector2f half_extents;
+  float radius = 0;
+  for (const ColliderShape* part : {&shape, &target}) {
+    if (part->kind == ColliderShape::Kind::kCircle) {
+      radius += part->half_extents.x;
+    } else {
+      half_extents += part->half_extents;
+    }
+  }
+
+  // The shapes overlap from the start, with the same tests as the colliders.
+  sf::Vector2f origin = shape.center;
+  sf::Vector2f min = center - half_extents;
+  sf::Vector2f max = center + half_extents;
+  sf::Vector2f closest = {std::clamp(origin.x, min.x, max.x),
+                          std::clamp(origin.y, min.y, max.y)};
+  if ((origin - closest).lengthSquared() <= radius * radius) {
+    return SweepContact{};
+  }
+  if (displacement == sf::Vector2f()) {
+    return std::nullopt;
+  }
+
+  if (radius == 0) {
+    return SweepPointBox(origin, displacement, min, max);
+  }
+
+  // The rounded rectangle is the union of the rectangle grown along each
+  // axis and of the circles at its corners, so the earliest entry into any of
+  // them is the entry into the sum.
+  std::optional<SweepContact> contact;
+  auto keep_earliest = [&contact](std::optional<SweepContact> candidate) {
+    if (candidate && (!contact || candidate->time < contact->time)) {
+      contact = candidate;
+    }
+  };
+  // A grown rectangle with no height, or no width, lies within the circles.
+  if (half_extents.y > 0) {
+    keep_earliest(SweepPointBox(origin, displacement,
+                                {min.x - radius, min.y},
+                                {max.x + radius, max.y}));
+  }
+  if (half_extents.x > 0) {
+    keep_earliest(SweepPointBox(origin, displacement,
+                                {min.x, min.y - radius},
+                                {max.x, max.y + radius}));
+  }
+  for (sf::Vector2f corner : {min, sf::Vector2f(max.x, min.y),
+                              sf::Vector2f(min.x, max.y), max}) {
+    keep_earliest(SweepPointCircle(origin, displacement, corner, radius));
+  }
+  return contact;
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <optional>
+
+#include "collider.h"
+
+namespace ng {
+
+/// @brief The first contact between a moving shape and a fixed shape.
+struct SweepContact {
+  // The fraction of the displacement covered before the contact, between 0 and 1. 0 if the shapes overlap from the start.
+  float time = 0;
+  // The outward normal of the fixed shape at the contact point. Zero if the shapes overlap from the start.
+  sf::Vector2f normal;
+};
+
+/// @brief Moves a shape by a displacement and finds the time of its first contact with a fixed shape, in a single test rather than by sampling positions.
+///        Touching shapes are in contact, as in the collider tests.
+/// @param shape The world space shape before the move.
+/// @param displacement The world space displacement of the shape.
+/// @param target The world space shape that does not move.
+/// @return The time and normal of the first contact, or nullopt if the shapes do not meet during the move.
+[[nodiscard]] std::optional<SweepContact> SweepShape(
+    const ColliderShape& shape, sf::Vector2f displacement,
+    const ColliderShape& target);
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <utility>
+
+namespace ng {
+
+ThreadPool::ThreadPool()
+    : ThreadPool(std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1) {
+}
+
+ThreadPool::ThreadPool(size_t thread_count) {
+  assert(thread_count > 0);
+  workers_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    workers_.emplace_back(
+        [this](const std::stop_token& stop_token) { WorkerLoop(stop_token); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  for (auto& worker : workers_) {
+    worker.request_stop();
+  }
+  // The workers are woken up by their stop token, then joined.
+  workers_.clear();
+}
+
+size_t ThreadPool::GetThreadCount() const {
+  return workers_.size();
+}
+
+void ThreadPool::Enqueue(std::move_only_function<void()> task) {
+  {
+    std::scoped_lock lock(mutex_);
+    tasks_.push_back(std::move(task));
+  }
+  condition_.notify_one();
+}
+
+void ThreadPool::WorkerLoop(const std::stop_token& stop_token) {
+  while (true) {
+    std::move_only_function<void()> task;
+    {
+      std::unique_lock lock(mutex_);
+      condition_.wait(lock, stop_token,
+                      [this]() -> bool { return !tasks_.empty(); });
+      if (stop_token.stop_requested()) {
+        return;
+      }
+
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+
+    task();
+  }
+}
+
+}  // namespace ng
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ng {
+
+/// @brief A fixed set of worker threads executing tasks in submission order.
+///        Used to move blocking work, such as file I/O and decoding, off the main thread.
+class ThreadPool {
+ public:
+  /// @brief Constructs a ThreadPool with one worker per hardware thread, minus the main thread, and at least one worker.
+  ThreadPool();
+
+  /// @brief Constructs a ThreadPool with a specific number of workers.
+  /// @param thread_count The number of worker threads. Must be greater than zero.
+  explicit ThreadPool(size_t thread_count);
+
+  /// @brief Stops the workers once they finish their current task. Queued tasks that have not started are discarded, breaking their futures.
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool& other) = delete;
+  ThreadPool& operator=(const ThreadPool& other) = delete;
+  ThreadPool(ThreadPool&& other) = delete;
+  ThreadPool& operator=(ThreadPool&& other) = delete;
+
+  /// @brief Schedules a function to be run on a worker thread.
+  /// @tparam F The type of the function, callable without arguments.
+  /// @param function The function to run. Exceptions it throws are stored in the returned future.
+  /// @return A future holding the result of the function once it has run.
+  template <typename F>
+  std::future<std::invoke_result_t<F>> Submit(F&& function) {
+    std::packaged_task<std::invoke_result_t<F>()> task(
+        std::forward<F>(function));
+    auto future = task.get_future();
+    Enqueue(std::move(task));
+    return future;
+  }
+
+  /// @brief Returns the number of worker threads.
+  /// @return The number of worker threads.
+  [[nodiscard]] size_t GetThreadCount() const;
+
+ private:
+  /// @brief Adds a task to the queue and wakes up a worker.
+  /// @param task The task to run.
+  void Enqueue(std::move_only_function<void()> task);
+
+  /// @brief The loop run by every worker, popping and running tasks until a stop is requested.
+  /// @param stop_token The token signaling the destruction of the pool.
+  void WorkerLoop(const std::stop_token& stop_token);
+
+  // Protects tasks_.
+  std::mutex mutex_;
+  // Signaled when a task is queued or a stop is requested.
+  std::condition_variable_any condition_;
+  // The tasks waiting for a worker, in submission order.
+  std::deque<std::move_only_function<void()>> tasks_;
+  // The worker threads. Declared last, so that they are joined before the queue is destroyed.
+  std::vector<std::jthread> workers_;
+};
+
+}  // namespace ng
\ No newline at end of file
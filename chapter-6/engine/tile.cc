@@ -5,10 +5,10 @@
 
 namespace ng {
 
-Tile::Tile(TileID id) : id_(id) {}
+Tile::Tile(TileID id, bool is_solid) : id_(id), is_solid_(is_solid) {}
 
-Tile::Tile(TileID id, sf::IntRect texture_coords)
-    : id_(id), texture_coords_(texture_coords) {}
+Tile::Tile(TileID id, sf::IntRect texture_coords, bool is_solid)
+    : id_(id), texture_coords_(texture_coords), is_solid_(is_solid) {}
 
 TileID Tile::GetID() const {
   return id_;
@@ -18,4 +18,8 @@ const std::optional<sf::IntRect>& Tile::GetTextureCoords() const {
   return texture_coords_;
 }
 
+bool Tile::IsSolid() const {
+  return is_solid_;
+}
+
 }  // namespace ng
\ No newline at end of file
@@ -15,12 +15,14 @@ class Tile {
  public:
   /// @brief Constructs a Tile with only an ID. The texture coordinates will be empty.
   /// @param id The unique identifier for this tile.
-  explicit Tile(TileID id);
+  /// @param is_solid Whether the tile blocks the boxes moved through a Tilemap.
+  explicit Tile(TileID id, bool is_solid = false);
 
   /// @brief Constructs a Tile with an ID and its corresponding texture coordinates.
   /// @param id The unique identifier for this tile.
   /// @param texture_coords The rectangular coordinates within a texture atlas for this tile.
-  Tile(TileID id, sf::IntRect texture_coords);
+  /// @param is_solid Whether the tile blocks the boxes moved through a Tilemap.
+  Tile(TileID id, sf::IntRect texture_coords, bool is_solid = false);
 
   /// @brief Returns the unique identifier of the tile.
   /// @return The TileID of this tile.
@@ -30,11 +32,17 @@ class Tile {
   /// @return A constant reference to an optional sf::IntRect. It will contain the texture coordinates if set, or be empty otherwise.
   [[nodiscard]] const std::optional<sf::IntRect>& GetTextureCoords() const;
 
+  /// @brief Checks if the tile blocks the boxes moved through a Tilemap.
+  /// @return True if the tile is solid, false otherwise.
+  [[nodiscard]] bool IsSolid() const;
+
  private:
   // The unique identifier of the tile.
   TileID id_{};
   // Optional texture coordinates within a texture atlas. Empty if the tile doesn't have specific texture coordinates.
   std::optional<sf::IntRect> texture_coords_;
+  // Flag indicating if the tile blocks the boxes moved through a Tilemap.
+  bool is_solid_ = false;
 };
 
 }  // namespace ng
\ No newline at end of file
@@ -1,63 +1,48 @@
 #include "tilemap.h"
 
 #include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/View.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <span>
+#include <limits>
+#include <optional>
 #include <utility>
 
 #include "app.h"
+#include "collider.h"
 #include "node.h"
+#include "sweep.h"
 #include "tile.h"
 #include "tileset.h"
 
 namespace ng {
 
-static constexpr size_t kTriangleVertexCount = 3;
-static constexpr size_t kTrisInQuad = 2 * kTriangleVertexCount;
+// The side length of a chunk in tiles.
+static constexpr uint32_t kChunkSize = 16;
+// How far a box has to reach into a tile next to it to overlap it, so that a
+// box resting against a tile despite rounding errors can slide along it.
+static constexpr float kContactTolerance = 0.001F;
 
 Tilemap::Tilemap(App* app, sf::Vector2u size, Tileset tileset)
     : Node(app),
       size_(size),
       tileset_(std::move(tileset)),
-      vertices_(sf::PrimitiveType::Triangles, static_cast<size_t>(size_.x) *
-                                                  static_cast<size_t>(size_.y) *
-                                                  kTrisInQuad) {
+      chunk_count_((size_.x + kChunkSize - 1) / kChunkSize,
+                   (size_.y + kChunkSize - 1) / kChunkSize) {
   tiles_.resize(static_cast<size_t>(size_.x) * static_cast<size_t>(size_.y));
-
-  for (uint32_t y = 0; y < size_.y; ++y) {
-    for (uint32_t x = 0; x < size_.x; ++x) {
-      std::span<sf::Vertex> triangles =
-          std::span(&vertices_[(y * size_.x + x) * kTrisInQuad], kTrisInQuad);
-
-      sf::Vector2f tile_size = sf::Vector2f(tileset_.GetTileSize());
-      auto fx = static_cast<float>(x);
-      auto fy = static_cast<float>(y);
-
-      triangles[0].position = sf::Vector2f(fx * tile_size.x, fy * tile_size.y);
-      triangles[1].position =
-          sf::Vector2f((fx + 1) * tile_size.x, fy * tile_size.y);
-      triangles[2].position =
-          sf::Vector2f(fx * tile_size.x, (fy + 1) * tile_size.y);
-      triangles[3].position =
-          sf::Vector2f(fx * tile_size.x, (fy + 1) * tile_size.y);
-      triangles[4].position =
-          sf::Vector2f((fx + 1) * tile_size.x, fy * tile_size.y);
-      triangles[5].position =
-          sf::Vector2f((fx + 1) * tile_size.x, (fy + 1) * tile_size.y);
-
-      triangles[0].color = sf::Color::Transparent;
-      triangles[1].color = sf::Color::Transparent;
-      triangles[2].color = sf::Color::Transparent;
-      triangles[3].color = sf::Color::Transparent;
-      triangles[4].color = sf::Color::Transparent;
-      triangles[5].color = sf::Color::Transparent;
-    }
-  }
+  solid_tiles_.resize((tiles_.size() + 63) / 64);
+  set_tiles_.resize(solid_tiles_.size());
+  chunks_.resize(static_cast<size_t>(chunk_count_.x) *
+                 static_cast<size_t>(chunk_count_.y));
+  SetTickEnabled(false);
 }
 
 sf::Vector2u Tilemap::GetSize() const {
@@ -77,43 +62,36 @@ const Tile& Tilemap::GetTile(sf::Vector2u position) const {
 }
 
 void Tilemap::SetTile(sf::Vector2u position, TileID tile_id) {
-  tiles_[(position.y * size_.x) + position.x] = tile_id;
-
-  std::span<sf::Vertex> triangles =
-      std::span(&vertices_[(position.y * size_.x + position.x) * kTrisInQuad],
-                kTrisInQuad);
-
-  auto texture_coords = GetTile(position).GetTextureCoords();
-  if (texture_coords.has_value()) {
-    auto pos = sf::Vector2f(texture_coords->position);
-    auto size = sf::Vector2f(texture_coords->size);
-
-    triangles[0].texCoords = sf::Vector2f(pos.x, pos.y);
-    triangles[1].texCoords = sf::Vector2f(pos.x + size.x, pos.y);
-    triangles[2].texCoords = sf::Vector2f(pos.x, pos.y + size.y);
-    triangles[3].texCoords = sf::Vector2f(pos.x, pos.y + size.y);
-    triangles[4].texCoords = sf::Vector2f(pos.x + size.x, pos.y);
-    triangles[5].texCoords = sf::Vector2f(pos.x + size.x, pos.y + size.y);
-
-    triangles[0].color = sf::Color::White;
-    triangles[1].color = sf::Color::White;
-    triangles[2].color = sf::Color::White;
-    triangles[3].color = sf::Color::White;
-    triangles[4].color = sf::Color::White;
-    triangles[5].color = sf::Color::White;
+  size_t index = (position.y * size_.x) + position.x;
+  tiles_[index] = tile_id;
+
+  uint64_t bit = 1ULL << (index % 64);
+  set_tiles_[index / 64] |= bit;
+  if (tileset_.GetTile(tile_id).IsSolid()) {
+    solid_tiles_[index / 64] |= bit;
   } else {
-    triangles[0].color = sf::Color::Transparent;
-    triangles[1].color = sf::Color::Transparent;
-    triangles[2].color = sf::Color::Transparent;
-    triangles[3].color = sf::Color::Transparent;
-    triangles[4].color = sf::Color::Transparent;
-    triangles[5].color = sf::Color::Transparent;
+    solid_tiles_[index / 64] &= ~bit;
+  }
+
+  // The geometry is rebuilt lazily, so that editing many tiles of the same
+  // chunk in a single frame rebuilds it only once.
+  sf::Vector2u chunk_position = position / kChunkSize;
+  chunks_[(chunk_position.y * chunk_count_.x) + chunk_position.x].is_dirty =
+      true;
+}
+
+bool Tilemap::IsTileSolid(sf::Vector2u position) const {
+  if (!IsWithinBounds(position)) {
+    return false;
   }
+
+  size_t index = (position.y * size_.x) + position.x;
+  return ((solid_tiles_[index / 64] >> (index % 64)) & 1U) != 0;
 }
 
 bool Tilemap::IsWithinWorldBounds(sf::Vector2f world_position) const {
   sf::Vector2f tilemap_relative_position =
-      (world_position - GetGlobalTransform().getPosition());
+      (world_position - GetGlobalPosition());
 
   if (tilemap_relative_position.x < 0 || tilemap_relative_position.y < 0) {
     return false;
@@ -133,17 +111,396 @@ void Tilemap::SetWorldTile(sf::Vector2f world_position, TileID tile_id) {
   SetTile(WorldToTileSpace(world_position), tile_id);
 }
 
+bool Tilemap::IsWorldTileSolid(sf::Vector2f world_position) const {
+  return IsWithinWorldBounds(world_position) &&
+         IsTileSolid(WorldToTileSpace(world_position));
+}
+
+TileMoveResult Tilemap::MoveAndCollide(sf::FloatRect bounds,
+                                       sf::Vector2f velocity) const {
+  sf::Vector2f origin = GetGlobalPosition();
+  sf::Vector2f min = bounds.position - origin;
+  sf::Vector2f max = min + bounds.size;
+  TileMoveResult result{.bounds = bounds, .velocity = velocity};
+
+  if (velocity.x != 0) {
+    float lead = velocity.x > 0 ? max.x : min.x;
+    float moved = velocity.x;
+    if (std::optional<float> edge =
+            FindSolidEdge(lead, velocity.x, min.y, max.y, true)) {
+      moved = *edge - lead;
+      result.velocity.x = 0;
+      (velocity.x > 0 ? result.hit_right : result.hit_left) = true;
+    }
+    min.x += moved;
+    max.x += moved;
+  }
+
+  if (velocity.y != 0) {
+    float lead = velocity.y > 0 ? max.y : min.y;
+    float moved = velocity.y;
+    if (std::optional<float> edge =
+            FindSolidEdge(lead, velocity.y, min.x, max.x, false)) {
+      moved = *edge - lead;
+      result.velocity.y = 0;
+      (velocity.y > 0 ? result.hit_bottom : result.hit_top) = true;
+    }
+    min.y += moved;
+    max.y += moved;
+  }
+
+  auto extent = sf::Vector2f(size_.componentWiseMul(GetTileSize()));
+  result.bounds = {min + origin, max - min};
+  result.is_out_of_bounds =
+      min.x < 0 || min.y < 0 || max.x > extent.x || max.y > extent.y;
+  return result;
+}
+
+std::optional<float> Tilemap::FindSolidEdge(float lead, float distance,
+                                            float cross_min, float cross_max,
+                                            bool is_horizontal) const {
+  sf::Vector2f tile_size = sf::Vector2f(tileset_.GetTileSize());
+  float tile_length = is_horizontal ? tile_size.x : tile_size.y;
+  float cross_tile_length = is_horizontal ? tile_size.y : tile_size.x;
+  auto count = static_cast<int64_t>(is_horizontal ? size_.x : size_.y);
+  auto cross_count = static_cast<int64_t>(is_horizontal ? size_.y : size_.x);
+
+  // The rows, or columns, covered by the box across the move.
+  int64_t first_cross = std::max<int64_t>(
+      static_cast<int64_t>(
+          std::floor((cross_min + kContactTolerance) / cross_tile_length)),
+      0);
+  int64_t last_cross = std::min<int64_t>(
+      static_cast<int64_t>(
+          std::ceil((cross_max - kContactTolerance) / cross_tile_length)) -
+          1,
+      cross_count - 1);
+  if (first_cross > last_cross) {
+    return std::nullopt;
+  }
+
+  auto is_line_solid = [&](int64_t line) -> bool {
+    for (int64_t cross = first_cross; cross <= last_cross; ++cross) {
+      sf::Vector2u position =
+          is_horizontal ? sf::Vector2u(static_cast<uint32_t>(line),
+                                       static_cast<uint32_t>(cross))
+                        : sf::Vector2u(static_cast<uint32_t>(cross),
+                                       static_cast<uint32_t>(line));
+      if (IsTileSolid(position)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  // Walks the columns, or rows, entered by the leading side in the order it
+  // enters them, starting from the one it is already in.
+  if (distance > 0) {
+    auto first = static_cast<int64_t>(std::ceil(lead / tile_length)) - 1;
+    auto last =
+        static_cast<int64_t>(std::ceil((lead + distance) / tile_length)) - 1;
+    for (int64_t line = std::max<int64_t>(first, 0);
+         line <= std::min(last, count - 1); ++line) {
+      if (is_line_solid(line)) {
+        return static_cast<float>(line) * tile_length;
+      }
+    }
+  } else {
+    auto first = static_cast<int64_t>(std::floor(lead / tile_length));
+    auto last =
+        static_cast<int64_t>(std::floor((lead + distance) / tile_length));
+    for (int64_t line = std::min(first, count - 1);
+         line >= std::max<int64_t>(last, 0); --line) {
+      if (is_line_solid(line)) {
+        return static_cast<float>(line + 1) * tile_length;
+      }
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::optional<TileRaycastHit> Tilemap::Raycast(sf::Vector2f origin,
+                                               sf::Vector2f direction,
+                                               float max_distance) const {
+  assert(direction != sf::Vector2f());
+  direction = direction.normalized();
+  sf::Vector2f tile_size = sf::Vector2f(tileset_.GetTileSize());
+  sf::Vector2f start = origin - GetGlobalPosition();
+  auto extent = sf::Vector2f(size_.componentWiseMul(GetTileSize()));
+
+  // Clips the ray to the tilemap first, so that the traversal only visits
+  // tiles of the map and always ends.
+  static constexpr float kInfinity = std::numeric_limits<float>::infinity();
+  float enter = 0;
+  float exit = max_distance;
+  sf::Vector2f normal;
+  for (bool is_x : {true, false}) {
+    float position = is_x ? start.x : start.y;
+    float delta = is_x ? direction.x : direction.y;
+    float length = is_x ? extent.x : extent.y;
+    if (delta == 0) {
+      if (position < 0 || position > length) {
+        return std::nullopt;
+      }
+      continue;
+    }
+
+    float near_distance = ((delta > 0 ? 0.F : length) - position) / delta;
+    float far_distance = ((delta > 0 ? length : 0.F) - position) / delta;
+    if (near_distance > enter) {
+      enter = near_distance;
+      normal = is_x ? sf::Vector2f(delta > 0 ? -1.F : 1.F, 0.F)
+                    : sf::Vector2f(0.F, delta > 0 ? -1.F : 1.F);
+    }
+    exit = std::min(exit, far_distance);
+  }
+  if (enter > exit) {
+    return std::nullopt;
+  }
+
+  // The tile containing the entry point, clamped because the entry point can
+  // lie on the far side of the map.
+  sf::Vector2f entry = start + (direction * enter);
+  sf::Vector2i tile = {
+      std::clamp(static_cast<int32_t>(std::floor(entry.x / tile_size.x)), 0,
+                 static_cast<int32_t>(size_.x) - 1),
+      std::clamp(static_cast<int32_t>(std::floor(entry.y / tile_size.y)), 0,
+                 static_cast<int32_t>(size_.y) - 1)};
+
+  // The Amanatides-Woo traversal: next_x and next_y are the distances along
+  // the ray to the next vertical and horizontal tile boundaries.
+  sf::Vector2i step = {direction.x > 0 ? 1 : -1, direction.y > 0 ? 1 : -1};
+  float next_x = kInfinity;
+  float delta_x = kInfinity;
+  if (direction.x != 0) {
+    float boundary = static_cast<float>(tile.x + (step.x > 0 ? 1 : 0)) *
+                     tile_size.x;
+    next_x = (boundary - start.x) / direction.x;
+    delta_x = tile_size.x / std::abs(direction.x);
+  }
+  float next_y = kInfinity;
+  float delta_y = kInfinity;
+  if (direction.y != 0) {
+    float boundary = static_cast<float>(tile.y + (step.y > 0 ? 1 : 0)) *
+                     tile_size.y;
+    next_y = (boundary - start.y) / direction.y;
+    delta_y = tile_size.y / std::abs(direction.y);
+  }
+
+  float distance = enter;
+  while (true) {
+    sf::Vector2u position(tile);
+    if (IsTileSolid(position)) {
+      return TileRaycastHit{.tile = position,
+                            .point = origin + (direction * distance),
+                            .normal = normal,
+                            .distance = distance};
+    }
+
+    if (next_x < next_y) {
+      distance = next_x;
+      next_x += delta_x;
+      tile.x += step.x;
+      normal = {static_cast<float>(-step.x), 0.F};
+    } else {
+      distance = next_y;
+      next_y += delta_y;
+      tile.y += step.y;
+      normal = {0.F, static_cast<float>(-step.y)};
+    }
+
+    if (distance > exit || tile.x < 0 || tile.y < 0 ||
+        tile.x >= static_cast<int32_t>(size_.x) ||
+        tile.y >= static_cast<int32_t>(size_.y)) {
+      return std::nullopt;
+    }
+  }
+}
+
+bool Tilemap::SegmentBlocked(sf::Vector2f start, sf::Vector2f end) const {
+  if (start == end) {
+    return IsWorldTileSolid(start);
+  }
+
+  return Raycast(start, end - start, (end - start).length()).has_value();
+}
+
+std::optional<TileSweepHit> Tilemap::Sweep(const ColliderShape& shape,
+                                           sf::Vector2f displacement) const {
+  sf::Vector2f tile_size = sf::Vector2f(tileset_.GetTileSize());
+  ColliderShape local_shape = shape;
+  local_shape.center -= GetGlobalPosition();
+
+  // The tiles under the bounds swept by the shape, leaving out the ones it
+  // only touches.
+  sf::Vector2f min = local_shape.center - local_shape.half_extents;
+  sf::Vector2f max = local_shape.center + local_shape.half_extents;
+  sf::Vector2f swept_min = {min.x + std::min(displacement.x, 0.F),
+                            min.y + std::min(displacement.y, 0.F)};
+  sf::Vector2f swept_max = {max.x + std::max(displacement.x, 0.F),
+                            max.y + std::max(displacement.y, 0.F)};
+  auto first_tile = [](float coordinate, float length) -> int64_t {
+    return std::max<int64_t>(
+        static_cast<int64_t>(
+            std::floor((coordinate + kContactTolerance) / length)),
+        0);
+  };
+  auto last_tile = [](float coordinate, float length,
+                      uint32_t count) -> int64_t {
+    return std::min<int64_t>(
+        static_cast<int64_t>(
+            std::ceil((coordinate - kContactTolerance) / length)) -
+            1,
+        static_cast<int64_t>(count) - 1);
+  };
+  int64_t first_x = first_tile(swept_min.x, tile_size.x);
+  int64_t first_y = first_tile(swept_min.y, tile_size.y);
+  int64_t last_x = last_tile(swept_max.x, tile_size.x, size_.x);
+  int64_t last_y = last_tile(swept_max.y, tile_size.y, size_.y);
+
+  // The tiles are shrunk by the contact tolerance, so that a shape resting
+  // against a tile can slide along it.
+  ColliderShape tile_shape = {
+      .kind = ColliderShape::Kind::kRectangle,
+      .center = {},
+      .half_extents = (tile_size / 2.F) -
+                      sf::Vector2f(kContactTolerance, kContactTolerance)};
+  std::optional<TileSweepHit> hit;
+  for (int64_t y = first_y; y <= last_y; ++y) {
+    for (int64_t x = first_x; x <= last_x; ++x) {
+      sf::Vector2u position(static_cast<uint32_t>(x),
+                            static_cast<uint32_t>(y));
+      if (!IsTileSolid(position)) {
+        continue;
+      }
+
+      tile_shape.center =
+          sf::Vector2f(position).componentWiseMul(tile_size) +
+          (tile_size / 2.F);
+      std::optional<SweepContact> contact =
+          SweepShape(local_shape, displacement, tile_shape);
+      if (contact && (!hit || contact->time < hit->time)) {
+        hit = TileSweepHit{.tile = position,
+                           .time = contact->time,
+                           .normal = contact->normal};
+      }
+    }
+  }
+
+  return hit;
+}
+
 sf::Vector2u Tilemap::WorldToTileSpace(sf::Vector2f world_position) const {
-  return sf::Vector2u(
-      (world_position - GetGlobalTransform().getPosition())
-          .componentWiseDiv(sf::Vector2f(tileset_.GetTileSize())));
+  return sf::Vector2u((world_position - GetGlobalPosition())
+                          .componentWiseDiv(
+                              sf::Vector2f(tileset_.GetTileSize())));
+}
+
+std::optional<sf::FloatRect> Tilemap::GetLocalBounds() const {
+  return sf::FloatRect(
+      {0.F, 0.F}, sf::Vector2f(size_.componentWiseMul(GetTileSize())));
 }
 
 void Tilemap::Draw(sf::RenderTarget& target) {
+  // An empty tilemap has no chunk to clamp the visible range to.
+  if (chunk_count_.x == 0 || chunk_count_.y == 0) {
+    return;
+  }
+
+  // The view covers the [-1, 1] range in normalized device coordinates.
+  sf::FloatRect view_bounds =
+      target.getView().getInverseTransform().transformRect(
+          sf::FloatRect({-1.F, -1.F}, {2.F, 2.F}));
+  sf::FloatRect local_view_bounds =
+      GetGlobalMatrix().getInverse().transformRect(view_bounds);
+
+  sf::Vector2f chunk_world_size =
+      sf::Vector2f(tileset_.GetTileSize()) * static_cast<float>(kChunkSize);
+  sf::Vector2f min =
+      local_view_bounds.position.componentWiseDiv(chunk_world_size);
+  sf::Vector2f max = (local_view_bounds.position + local_view_bounds.size)
+                         .componentWiseDiv(chunk_world_size);
+
+  if (max.x < 0 || max.y < 0 || min.x >= static_cast<float>(chunk_count_.x) ||
+      min.y >= static_cast<float>(chunk_count_.y)) {
+    return;
+  }
+
+  auto first_x = static_cast<uint32_t>(std::max(min.x, 0.F));
+  auto first_y = static_cast<uint32_t>(std::max(min.y, 0.F));
+  uint32_t last_x = std::min(static_cast<uint32_t>(max.x), chunk_count_.x - 1);
+  uint32_t last_y = std::min(static_cast<uint32_t>(max.y), chunk_count_.y - 1);
+
   sf::RenderStates state;
-  state.transform = GetGlobalTransform().getTransform();
+  state.transform = GetGlobalMatrix();
   state.texture = tileset_.GetTexture();
-  target.draw(vertices_, state);
+  for (uint32_t y = first_y; y <= last_y; ++y) {
+    for (uint32_t x = first_x; x <= last_x; ++x) {
+      Chunk& chunk = chunks_[(y * chunk_count_.x) + x];
+      if (chunk.is_dirty) {
+        BuildChunk({x, y});
+      }
+
+      if (chunk.vertices.getVertexCount() > 0) {
+        target.draw(chunk.vertices, state);
+      }
+    }
+  }
+}
+
+void Tilemap::BuildChunk(sf::Vector2u chunk_position) {
+  Chunk& chunk =
+      chunks_[(chunk_position.y * chunk_count_.x) + chunk_position.x];
+  chunk.vertices.clear();
+  chunk.is_dirty = false;
+
+  sf::Vector2f tile_size = sf::Vector2f(tileset_.GetTileSize());
+  sf::Vector2u first = chunk_position * kChunkSize;
+  sf::Vector2u last = {std::min(first.x + kChunkSize, size_.x),
+                       std::min(first.y + kChunkSize, size_.y)};
+
+  for (uint32_t y = first.y; y < last.y; ++y) {
+    for (uint32_t x = first.x; x < last.x; ++x) {
+      size_t index = (y * size_.x) + x;
+      if (((set_tiles_[index / 64] >> (index % 64)) & 1U) == 0) {
+        continue;
+      }
+
+      const auto& texture_coords =
+          tileset_.GetTile(tiles_[index]).GetTextureCoords();
+      // Empty tiles have no geometry at all.
+      if (!texture_coords.has_value()) {
+        continue;
+      }
+
+      auto fx = static_cast<float>(x);
+      auto fy = static_cast<float>(y);
+      sf::Vector2f left_top(fx * tile_size.x, fy * tile_size.y);
+      sf::Vector2f right_bottom((fx + 1) * tile_size.x, (fy + 1) * tile_size.y);
+
+      auto pos = sf::Vector2f(texture_coords->position);
+      auto size = sf::Vector2f(texture_coords->size);
+
+      chunk.vertices.append(
+          {{left_top.x, left_top.y}, sf::Color::White, {pos.x, pos.y}});
+      chunk.vertices.append({{right_bottom.x, left_top.y},
+                             sf::Color::White,
+                             {pos.x + size.x, pos.y}});
+      chunk.vertices.append({{left_top.x, right_bottom.y},
+                             sf::Color::White,
+                             {pos.x, pos.y + size.y}});
+      chunk.vertices.append({{left_top.x, right_bottom.y},
+                             sf::Color::White,
+                             {pos.x, pos.y + size.y}});
+      chunk.vertices.append({{right_bottom.x, left_top.y},
+                             sf::Color::White,
+                             {pos.x + size.x, pos.y}});
+      chunk.vertices.append({{right_bottom.x, right_bottom.y},
+                             sf::Color::White,
+                             {pos.x + size.x, pos.y + size.y}});
+    }
+  }
 }
 
 }  // namespace ng
\ No newline at end of file
@@ -1,17 +1,62 @@
 #pragma once
 
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <cstdint>
+#include <optional>
 #include <vector>
 
 #include "app.h"
+#include "collider.h"
 #include "node.h"
 #include "tile.h"
 #include "tileset.h"
 
 namespace ng {
 
+/// @brief The outcome of moving a box through the solid tiles of a Tilemap.
+struct TileMoveResult {
+  // The bounds of the box after the move, in world space.
+  sf::FloatRect bounds;
+  // The velocity of the box after the move, with the components stopped by a solid tile set to 0.
+  sf::Vector2f velocity;
+  // Flag indicating if the left side of the box was stopped by a solid tile.
+  bool hit_left = false;
+  // Flag indicating if the right side of the box was stopped by a solid tile.
+  bool hit_right = false;
+  // Flag indicating if the top side of the box was stopped by a solid tile.
+  bool hit_top = false;
+  // Flag indicating if the bottom side of the box was stopped by a solid tile, i.e. the box landed.
+  bool hit_bottom = false;
+  // Flag indicating if the box ended up partly or entirely outside of the tilemap.
+  bool is_out_of_bounds = false;
+};
+
+/// @brief The first solid tile hit by a ray cast through a Tilemap.
+struct TileRaycastHit {
+  // The tile coordinates of the hit tile.
+  sf::Vector2u tile;
+  // The world space point where the ray enters the tile.
+  sf::Vector2f point;
+  // The outward normal of the side of the tile the ray enters through. Zero if the ray starts inside the tile.
+  sf::Vector2f normal;
+  // The distance from the origin of the ray to the hit point.
+  float distance = 0;
+};
+
+/// @brief The first solid tile hit by a shape swept through a Tilemap.
+struct TileSweepHit {
+  // The tile coordinates of the hit tile.
+  sf::Vector2u tile;
+  // The fraction of the displacement covered before the contact, between 0 and 1. 0 if the shape overlaps the tile from the start.
+  float time = 0;
+  // The outward normal of the tile at the contact point. Zero if the shape overlaps the tile from the start.
+  sf::Vector2f normal;
+};
+
 /// @brief Represents a grid-based map composed of tiles from a Tileset.
 class Tilemap : public Node {
  public:
@@ -41,9 +86,15 @@ class Tilemap : public Node {
 
   /// @brief Sets the Tile at the specified tile coordinates using its TileID.
   /// @param position The tile coordinates to set the tile at.
-  /// @param tile_id The ID of the tile to set.
+  /// @param tile_id The ID of the tile to set. Must be part of the tileset.
   void SetTile(sf::Vector2u position, TileID tile_id);
 
+  /// @brief Checks if the tile at the specified tile coordinates is solid, without looking it up in the tileset.
+  ///        Tiles that were never set are not solid.
+  /// @param position The tile coordinates to check.
+  /// @return True if the position is within the bounds and its tile is solid, false otherwise.
+  [[nodiscard]] bool IsTileSolid(sf::Vector2u position) const;
+
   /// @brief Checks if a given world position is within the bounds of the tilemap.
   /// @param world_position The world coordinates to check.
   /// @return True if the world position corresponds to a tile within the bounds, false otherwise.
@@ -59,26 +110,100 @@ class Tilemap : public Node {
   /// @param tile_id The ID of the tile to set.
   void SetWorldTile(sf::Vector2f world_position, TileID tile_id);
 
+  /// @brief Checks if the tile at the specified world coordinates is solid, without looking it up in the tileset.
+  /// @param world_position The world coordinates to check.
+  /// @return True if the world position is within the bounds and its tile is solid, false otherwise.
+  [[nodiscard]] bool IsWorldTileSolid(sf::Vector2f world_position) const;
+
+  /// @brief Moves a box by a velocity, stopping it against the solid tiles on its way.
+  ///        The box moves along the x axis first, then along the y axis from its new position. Only the tiles crossed by the sides of the box are tested.
+  ///        Tiles outside of the tilemap are not solid, and a box touching a solid tile without entering it is not stopped by it.
+  /// @param bounds The world space bounds of the box before the move.
+  /// @param velocity The displacement of the box.
+  /// @return The bounds and velocity of the box after the move, and the sides that were stopped.
+  [[nodiscard]] TileMoveResult MoveAndCollide(sf::FloatRect bounds,
+                                              sf::Vector2f velocity) const;
+
+  /// @brief Finds the first solid tile along a ray, visiting each tile crossed by the ray once, in order.
+  ///        Tiles outside of the tilemap are not solid. A ray starting inside a solid tile hits it at its origin.
+  /// @param origin The world space origin of the ray.
+  /// @param direction The direction of the ray. Does not need to be normalized, but must not be zero.
+  /// @param max_distance The length of the ray in world units.
+  /// @return The first solid tile hit within max_distance, or nullopt if there is none.
+  [[nodiscard]] std::optional<TileRaycastHit> Raycast(
+      sf::Vector2f origin, sf::Vector2f direction, float max_distance) const;
+
+  /// @brief Checks if a solid tile lies on the segment between two world positions, as in a line of sight test.
+  /// @param start The world space start of the segment.
+  /// @param end The world space end of the segment.
+  /// @return True if a solid tile is crossed by or touches the segment, false otherwise.
+  [[nodiscard]] bool SegmentBlocked(sf::Vector2f start, sf::Vector2f end) const;
+
+  /// @brief Moves a shape by a displacement and finds the first solid tile it would hit, without sampling positions along the way.
+  ///        Every tile under the bounds swept by the shape is tested, so that fast shapes do not pass through thin walls.
+  ///        Tiles outside of the tilemap are not solid, and a shape touching a solid tile without entering it does not hit it, as in MoveAndCollide.
+  /// @param shape The world space shape before the move.
+  /// @param displacement The world space displacement of the shape.
+  /// @return The first solid tile hit and the time of the hit, or nullopt if the way is free.
+  [[nodiscard]] std::optional<TileSweepHit> Sweep(
+      const ColliderShape& shape, sf::Vector2f displacement) const;
+
   /// @brief Converts world coordinates to tile coordinates.
   /// @param world_position The world coordinates to convert.
   /// @return The corresponding tile coordinates.
   [[nodiscard]] sf::Vector2u WorldToTileSpace(
       sf::Vector2f world_position) const;
 
+  /// @brief Returns the bounds of the whole tilemap in its local space.
+  /// @return The local bounds of the tilemap.
+  [[nodiscard]] std::optional<sf::FloatRect> GetLocalBounds() const override;
+
  protected:
-  /// @brief Renders the tilemap.
+  /// @brief Renders the chunks of the tilemap that intersect the current view of the target.
   /// @param target The SFML RenderTarget to draw to.
   void Draw(sf::RenderTarget& target) override;
 
  private:
+  /// @brief A square block of tiles rendered with its own vertex array.
+  struct Chunk {
+    // The vertices of the non-empty tiles of the chunk, in tilemap local space.
+    sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+    // Flag indicating if the vertices need to be rebuilt before the next draw.
+    bool is_dirty = true;
+  };
+
+  /// @brief Finds the first solid tile crossed by the leading side of a box moving along one axis.
+  /// @param lead The local coordinate of the leading side of the box along the axis of the move.
+  /// @param distance The signed distance of the move.
+  /// @param cross_min The local coordinate of the start of the box on the other axis.
+  /// @param cross_max The local coordinate of the end of the box on the other axis.
+  /// @param is_horizontal Whether the box moves along the x axis rather than the y axis.
+  /// @return The local coordinate of the side of the first solid tile facing the box, or nullopt if the way is free.
+  [[nodiscard]] std::optional<float> FindSolidEdge(float lead, float distance,
+                                                   float cross_min,
+                                                   float cross_max,
+                                                   bool is_horizontal) const;
+
+  /// @brief Rebuilds the vertex array of a chunk from its tiles.
+  /// @param chunk_position The chunk coordinates of the chunk to rebuild.
+  void BuildChunk(sf::Vector2u chunk_position);
+
   // The dimensions of the tilemap in tiles.
   sf::Vector2u size_;
   // The tileset used by this tilemap. Ownership is held by the Tilemap.
   Tileset tileset_;
   // A vector storing the TileID for each tile in the map.
   std::vector<TileID> tiles_;
-  // The vertex array used for rendering the tilemap efficiently.
-  sf::VertexArray vertices_;
+  // One bit per tile of the map, in the order of tiles_, set if the tile is solid.
+  // Kept separately so that collision tests do not look the tiles up in the tileset.
+  std::vector<uint64_t> solid_tiles_;
+  // One bit per tile of the map, in the order of tiles_, set once the tile has been set.
+  // Tiles never set are left empty rather than looked up in the tileset, which may not have their default TileID.
+  std::vector<uint64_t> set_tiles_;
+  // The dimensions of the tilemap in chunks.
+  sf::Vector2u chunk_count_;
+  // The chunks of the tilemap, stored row by row.
+  std::vector<Chunk> chunks_;
 };
 
 }  // namespace ng
\ No newline at end of file
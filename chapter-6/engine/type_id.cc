@@ -0,0 +1,16 @@
+#include "type_id.h"
+
+#include <atomic>
+
+namespace ng {
+
+namespace internal {
+
+TypeId NextTypeId() {
+  static std::atomic<TypeId> next_id = 0;
+  return next_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // namespace internal
+
+}  // namespace ng
\ No newline at end of file
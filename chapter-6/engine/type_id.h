@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ng {
+
+/// @brief A compact identifier of a type, unique within the program.
+using TypeId = uint32_t;
+
+namespace internal {
+
+/// @brief Returns a new TypeId, distinct from all the previously returned ones. Thread-safe.
+/// @return The new TypeId.
+TypeId NextTypeId();
+
+}  // namespace internal
+
+/// @brief Returns the TypeId of a type. IDs are assigned on first use, so they are dense but may change between runs.
+/// @tparam T The type to identify.
+/// @return The TypeId of T, the same on every call.
+template <typename T>
+[[nodiscard]] TypeId GetTypeId() {
+  static const TypeId kId = internal::NextTypeId();
+  return kId;
+}
+
+}  // namespace ng
\ No newline at end of file
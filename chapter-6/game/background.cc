@@ -20,8 +20,6 @@ Background::Background(ng::App* app, sf::Vector2u size)
       size_(size),
       texture_(&GetApp()->GetResourceManager().LoadTexture("Gray.png")),
       image_vertices_(sf::PrimitiveType::Triangles, kTrisInQuad) {
-  texture_->setRepeated(true);
-
   sf::Vector2f fsize(size_);
   image_vertices_[0].position = sf::Vector2f(0, 0);
   image_vertices_[1].position = sf::Vector2f(fsize.x, 0);
@@ -31,6 +29,11 @@ Background::Background(ng::App* app, sf::Vector2u size)
   image_vertices_[5].position = sf::Vector2f(fsize.x, fsize.y);
 }
 
+void Background::OnAdd() {
+  // Changes the OpenGL texture, so it waits for the main thread.
+  texture_->setRepeated(true);
+}
+
 void Background::Update() {
   static constexpr int32_t kScrollTicksPerPixel = 4;
   float offset = -static_cast<float>(t_) / kScrollTicksPerPixel;
@@ -50,7 +53,7 @@ void Background::Update() {
 void Background::Draw(sf::RenderTarget& target) {
   sf::RenderStates state;
   state.texture = texture_;
-  state.transform = GetGlobalTransform().getTransform();
+  state.transform = GetGlobalMatrix();
   target.draw(image_vertices_, state);
 }
 
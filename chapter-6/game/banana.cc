@@ -1,20 +1,27 @@
 #include "banana.h"
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
+#include <SFML/System/Vector2.hpp>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
 
+#include "collision_layer.h"
 #include "engine/app.h"
 #include "engine/circle_collider.h"
 #include "engine/node.h"
+#include "engine/scene.h"
 #include "engine/sprite_sheet_animation.h"
 #include "engine/state.h"
+#include "sprite_frame.h"
 
 namespace game {
 
 static constexpr int32_t kAnimationTPF = 4;
+static constexpr sf::Vector2i kFrameSize = {32, 32};
 
 Banana::IdleState::IdleState(ng::State<Context>::ID id,
                              ng::SpriteSheetAnimation animation)
@@ -36,11 +43,12 @@ Banana::Banana(ng::App* app)
                                           &sprite_, &sprite_.getTexture(),
                                           kAnimationTPF))) {
   SetName("Banana");
-  sprite_.setScale({2, 2});
-  sprite_.setOrigin({16, 16});
-  sprite_.setTextureRect(sf::IntRect({0, 0}, {32, 32}));
+  SetDrawnDirectly(false);
+  SetUpSpriteFrame(sprite_, kFrameSize);
 
-  MakeChild<ng::CircleCollider>(16.F);
+  auto& collider = MakeChild<ng::CircleCollider>(16.F);
+  collider.SetCollisionCategory(kPickupLayer);
+  collider.SetCollisionMask(kPlayerLayer);
 }
 
 bool Banana::GetIsCollected() const {
@@ -60,8 +68,12 @@ void Banana::Update() {
   animator_.Update();
 }
 
-void Banana::Draw(sf::RenderTarget& target) {
-  target.draw(sprite_, GetGlobalTransform().getTransform());
+std::optional<sf::FloatRect> Banana::GetLocalBounds() const {
+  return GetSpriteFrameBounds(kFrameSize);
+}
+
+void Banana::Draw([[maybe_unused]] sf::RenderTarget& target) {
+  GetScene()->GetSpriteBatch().Draw(sprite_, GetGlobalMatrix());
 }
 
 }  // namespace game
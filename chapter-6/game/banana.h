@@ -1,7 +1,9 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
+#include <optional>
 
 #include "engine/circle_collider.h"
 #include "engine/fsm.h"
@@ -17,6 +19,7 @@ class Banana : public ng::Node {
 
   bool GetIsCollected() const;
   void Collect();
+  std::optional<sf::FloatRect> GetLocalBounds() const override;
 
  protected:
   void Update() override;
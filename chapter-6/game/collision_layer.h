@@ -0,0 +1,17 @@
+#pragma once
+
+#include "engine/collision_layer.h"
+
+namespace game {
+
+inline constexpr ng::CollisionLayer kPlayerLayer = ng::CollisionLayer::kDefault;
+inline constexpr ng::CollisionLayer kEnemyLayer =
+    static_cast<ng::CollisionLayer>(1U << 1U);
+inline constexpr ng::CollisionLayer kEnemyProjectileLayer =
+    static_cast<ng::CollisionLayer>(1U << 2U);
+inline constexpr ng::CollisionLayer kPickupLayer =
+    static_cast<ng::CollisionLayer>(1U << 3U);
+inline constexpr ng::CollisionLayer kGoalLayer =
+    static_cast<ng::CollisionLayer>(1U << 4U);
+
+}  // namespace game
\ No newline at end of file
@@ -11,6 +11,7 @@
 #include "engine/camera.h"
 #include "engine/layer.h"
 #include "engine/node.h"
+#include "engine/physics.h"
 #include "engine/scene.h"
 #include "engine/tile.h"
 #include "engine/tilemap.h"
@@ -26,7 +27,9 @@
 namespace game {
 
 std::unique_ptr<ng::Scene> MakeDefaultScene(ng::App* app) {
-  auto scene = std::make_unique<ng::Scene>(app);
+  // A handful of colliders, which a scan goes through faster than any grid.
+  auto scene =
+      std::make_unique<ng::Scene>(app, ng::PhysicsBroadphase::kScan);
   scene->SetName("Scene");
 
   ng::Tileset tileset(
@@ -34,42 +37,58 @@ std::unique_ptr<ng::Scene> MakeDefaultScene(ng::App* app) {
 
   {
     tileset.AddTile(ng::Tile(TileID::kVoid));
-    tileset.AddTile(ng::Tile(TileID::kInvisibleBarrier));
+    tileset.AddTile(ng::Tile(TileID::kInvisibleBarrier, /*is_solid=*/true));
 
     tileset.AddTile(ng::Tile(TileID::kDirtTopLeft,
-                             sf::IntRect({6 * 16, 0 * 16}, {16, 16})));
+                             sf::IntRect({6 * 16, 0 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtTopCenter,
-                             sf::IntRect({7 * 16, 0 * 16}, {16, 16})));
+                             sf::IntRect({7 * 16, 0 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtTopRight,
-                             sf::IntRect({8 * 16, 0 * 16}, {16, 16})));
+                             sf::IntRect({8 * 16, 0 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtMiddleLeft,
-                             sf::IntRect({6 * 16, 1 * 16}, {16, 16})));
+                             sf::IntRect({6 * 16, 1 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtMiddleCenter,
-                             sf::IntRect({7 * 16, 1 * 16}, {16, 16})));
+                             sf::IntRect({7 * 16, 1 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtMiddleRight,
-                             sf::IntRect({8 * 16, 1 * 16}, {16, 16})));
+                             sf::IntRect({8 * 16, 1 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtBottomLeft,
-                             sf::IntRect({6 * 16, 2 * 16}, {16, 16})));
+                             sf::IntRect({6 * 16, 2 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtBottomCenter,
-                             sf::IntRect({7 * 16, 2 * 16}, {16, 16})));
+                             sf::IntRect({7 * 16, 2 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kDirtBottomRight,
-                             sf::IntRect({8 * 16, 2 * 16}, {16, 16})));
+                             sf::IntRect({8 * 16, 2 * 16}, {16, 16}),
+                             /*is_solid=*/true));
 
     tileset.AddTile(ng::Tile(TileID::kStoneHorizontalLeft,
-                             sf::IntRect({12 * 16, 4 * 16}, {16, 16})));
+                             sf::IntRect({12 * 16, 4 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kStoneHorizontalCenter,
-                             sf::IntRect({13 * 16, 4 * 16}, {16, 16})));
+                             sf::IntRect({13 * 16, 4 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kStoneHorizontalRight,
-                             sf::IntRect({14 * 16, 4 * 16}, {16, 16})));
+                             sf::IntRect({14 * 16, 4 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kStoneVerticalTop,
-                             sf::IntRect({15 * 16, 4 * 16}, {16, 16})));
+                             sf::IntRect({15 * 16, 4 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kStoneVerticalMiddle,
-                             sf::IntRect({15 * 16, 5 * 16}, {16, 16})));
+                             sf::IntRect({15 * 16, 5 * 16}, {16, 16}),
+                             /*is_solid=*/true));
     tileset.AddTile(ng::Tile(TileID::kStoneVerticalBottom,
-                             sf::IntRect({15 * 16, 6 * 16}, {16, 16})));
+                             sf::IntRect({15 * 16, 6 * 16}, {16, 16}),
+                             /*is_solid=*/true));
 
     tileset.AddTile(ng::Tile(TileID::kPlasticBlock,
-                             sf::IntRect({12 * 16, 9 * 16}, {16, 16})));
+                             sf::IntRect({12 * 16, 9 * 16}, {16, 16}),
+                             /*is_solid=*/true));
   }
 
   auto tmp_tilemap =
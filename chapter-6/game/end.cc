@@ -1,22 +1,29 @@
 #include "end.h"
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
+#include <SFML/System/Vector2.hpp>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
 
+#include "collision_layer.h"
 #include "engine/app.h"
 #include "engine/node.h"
 #include "engine/rectangle_collider.h"
+#include "engine/scene.h"
 #include "engine/sprite_sheet_animation.h"
 #include "engine/state.h"
 #include "engine/transition.h"
 #include "game_manager.h"
+#include "sprite_frame.h"
 
 namespace game {
 
 static constexpr int32_t kAnimationTPF = 4;
+static constexpr sf::Vector2i kFrameSize = {64, 64};
 
 End::IdleState::IdleState(ng::State<Context>::ID id,
                           ng::SpriteSheetAnimation animation)
@@ -58,11 +65,13 @@ End::End(ng::App* app, GameManager* game_manager)
                                            kAnimationTPF))),
       game_manager_(game_manager) {
   SetName("End");
-  sprite_.setScale({2, 2});
-  sprite_.setOrigin({32, 32});
+  SetDrawnDirectly(false);
+  SetUpSpriteFrame(sprite_, kFrameSize);
 
   auto& collider = MakeChild<ng::RectangleCollider>(sf::Vector2f(60, 32));
   collider.SetLocalPosition({0, -20});
+  collider.SetCollisionCategory(kGoalLayer);
+  collider.SetCollisionMask(kPlayerLayer);
 
   animator_.AddState(std::make_unique<PressedState>(
       "pressed",
@@ -88,8 +97,12 @@ void End::Update() {
   animator_.Update();
 }
 
-void End::Draw(sf::RenderTarget& target) {
-  target.draw(sprite_, GetGlobalTransform().getTransform());
+std::optional<sf::FloatRect> End::GetLocalBounds() const {
+  return GetSpriteFrameBounds(kFrameSize);
+}
+
+void End::Draw([[maybe_unused]] sf::RenderTarget& target) {
+  GetScene()->GetSpriteBatch().Draw(sprite_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
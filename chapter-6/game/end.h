@@ -1,8 +1,10 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <optional>
 
 #include "engine/fsm.h"
 #include "engine/node.h"
@@ -16,6 +18,7 @@ class End : public ng::Node {
   End(ng::App* app, GameManager* game_manager);
 
   void EndGame();
+  std::optional<sf::FloatRect> GetLocalBounds() const override;
 
  protected:
   void Update() override;
@@ -5,6 +5,7 @@
 
 #include "engine/app.h"
 #include "engine/node.h"
+#include "engine/node_handle.h"
 #include "engine/scene.h"
 #include "engine/tilemap.h"
 #include "player.h"
@@ -13,7 +14,9 @@ namespace game {
 
 FollowPlayer::FollowPlayer(ng::App* app, const Player* player,
                            const ng::Tilemap* tilemap)
-    : ng::Node(app), player_(player), tilemap_(tilemap) {}
+    : ng::Node(app), player_(player), tilemap_(tilemap) {
+  SetDrawnDirectly(false);
+}
 
 void FollowPlayer::OnAdd() {
   Follow();
@@ -24,14 +27,20 @@ void FollowPlayer::Update() {
 }
 
 void FollowPlayer::Follow() {
-  if (!GetScene()->IsValid(player_)) {
+  // The player may be added to the scene after the camera, and only has a
+  // handle from then on. Once taken, the handle tells whether the player is
+  // still alive without touching it.
+  if (player_handle_ == ng::NodeHandle()) {
+    player_handle_ = player_->GetHandle();
+  }
+  if (!GetScene()->IsValid(player_handle_)) {
     return;
   }
 
   sf::Vector2f tilemap_size = sf::Vector2f(tilemap_->GetSize());
   sf::Vector2f tile_size = sf::Vector2f(tilemap_->GetTileSize());
   sf::Vector2f window_size = sf::Vector2f(GetApp()->GetWindow().getSize());
-  sf::Vector2f player_pos = player_->GetGlobalTransform().getPosition();
+  sf::Vector2f player_pos = player_->GetGlobalPosition();
   sf::Vector2f new_pos(
       std::min(
           std::max(player_pos.x, tile_size.x * window_size.x / tile_size.x / 2),
@@ -2,6 +2,7 @@
 
 #include "engine/app.h"
 #include "engine/node.h"
+#include "engine/node_handle.h"
 #include "engine/tilemap.h"
 #include "player.h"
 
@@ -19,6 +20,7 @@ class FollowPlayer : public ng::Node {
   void Follow();
 
   const Player* player_ = nullptr;
+  ng::NodeHandle player_handle_;
   const ng::Tilemap* tilemap_ = nullptr;
 };
 
@@ -2,6 +2,7 @@
 
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Window/Keyboard.hpp>
+#include <optional>
 
 #include "default_scene.h"
 #include "engine/app.h"
@@ -11,13 +12,16 @@
 
 namespace game {
 
-GameManager::GameManager(ng::App* app)
-    : ng::Node(app),
-      win_sound_(GetApp()->GetResourceManager().LoadSoundBuffer("Win_2.wav")),
-      lose_sound_(
-          GetApp()->GetResourceManager().LoadSoundBuffer("Loose_2.wav")) {}
+GameManager::GameManager(ng::App* app) : ng::Node(app) {
+  SetDrawnDirectly(false);
+}
 
 void GameManager::OnAdd() {
+  win_sound_.emplace(
+      GetApp()->GetResourceManager().LoadSoundBuffer("Win_2.wav"));
+  lose_sound_.emplace(
+      GetApp()->GetResourceManager().LoadSoundBuffer("Loose_2.wav"));
+
   auto& win_canvas = GetParent()->MakeChild<WinCanvas>();
   win_canvas_ = &win_canvas;
 
@@ -29,8 +33,13 @@ void GameManager::OnAdd() {
 
 void GameManager::Update() {
   if (state_ == State::WON || state_ == State::LOST) {
-    if (GetApp()->GetInput().GetKeyDown(sf::Keyboard::Scancode::Enter)) {
-      GetApp()->LoadScene(MakeDefaultScene(GetApp()));
+    if (GetApp()->GetInput().GetKeyDown(sf::Keyboard::Scancode::Enter) &&
+        !GetApp()->IsSceneLoading()) {
+      // Built in the background while this scene keeps running. The nodes
+      // only create their sounds once added, on the main thread, which also
+      // uploads their textures.
+      ng::App* app = GetApp();
+      app->LoadSceneAsync([app]() { return MakeDefaultScene(app); });
       return;
     }
   }
@@ -43,7 +52,7 @@ void GameManager::Win() {
 
   state_ = State::WON;
   win_canvas_->Enable();
-  win_sound_.play();
+  win_sound_->play();
 }
 
 void GameManager::Lose() {
@@ -53,7 +62,7 @@ void GameManager::Lose() {
 
   state_ = State::LOST;
   lose_canvas_->Enable();
-  lose_sound_.play();
+  lose_sound_->play();
 }
 
 GameManager::State GameManager::GetState() const {
@@ -2,6 +2,7 @@
 
 #include <SFML/Audio/Sound.hpp>
 #include <cstdint>
+#include <optional>
 
 #include "engine/node.h"
 #include "lose_canvas.h"
@@ -31,8 +32,9 @@ class GameManager : public ng::Node {
 
  private:
   State state_{};
-  sf::Sound win_sound_;
-  sf::Sound lose_sound_;
+  // Created in OnAdd.
+  std::optional<sf::Sound> win_sound_;
+  std::optional<sf::Sound> lose_sound_;
 
   WinCanvas* win_canvas_ = nullptr;
   LoseCanvas* lose_canvas_ = nullptr;
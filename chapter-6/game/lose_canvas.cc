@@ -17,6 +17,7 @@ LoseCanvas::LoseCanvas(ng::App* app)
           GetApp()->GetResourceManager().LoadFont("Roboto-Regular.ttf")) {
   SetName("LoseCanvas");
   SetLayer(ng::Layer::kUI);
+  SetTickEnabled(false);
 
   background_.setFillColor(sf::Color(50, 50, 50, 200));
 
@@ -49,9 +50,9 @@ void LoseCanvas::Draw(sf::RenderTarget& target) {
   background_.setSize(sf::Vector2f(GetApp()->GetWindow().getSize()));
   background_.setOrigin(sf::Vector2f(GetApp()->GetWindow().getSize()) / 2.F);
 
-  target.draw(background_, GetGlobalTransform().getTransform());
-  target.draw(title_text_, GetGlobalTransform().getTransform());
-  target.draw(restart_text_, GetGlobalTransform().getTransform());
+  target.draw(background_, GetGlobalMatrix());
+  target.draw(title_text_, GetGlobalMatrix());
+  target.draw(restart_text_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
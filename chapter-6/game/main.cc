@@ -1,5 +1,6 @@
 #include "default_scene.h"
 #include "engine/app.h"
+#include "engine/profiler.h"
 
 #include <SFML/System/Vector2.hpp>
 #include <cstdlib>
@@ -8,5 +9,8 @@ int main() {
   static constexpr sf::Vector2u kWindowSize = {832U, 640U};
   ng::App app(kWindowSize, "Platformer", 60, 60);
   app.LoadScene(game::MakeDefaultScene(&app)).Run();
+#ifdef NG_PROFILE
+  ng::Profiler::Get().WriteChromeTrace("trace.json");
+#endif
   return EXIT_SUCCESS;
 }
@@ -1,42 +1,32 @@
 #include "mushroom.h"
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
-#include <cmath>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
-#include <vector>
 
+#include "collision_layer.h"
 #include "engine/app.h"
 #include "engine/collider.h"
 #include "engine/node.h"
 #include "engine/rectangle_collider.h"
+#include "engine/scene.h"
 #include "engine/sprite_sheet_animation.h"
 #include "engine/state.h"
 #include "engine/tilemap.h"
 #include "engine/transition.h"
 #include "player.h"
-#include "tile_id.h"
+#include "sprite_frame.h"
 
 namespace game {
 
-namespace {
-
-bool DoesCollide(sf::Vector2f position, const ng::Tilemap& tilemap) {
-  TileID id = tilemap.GetWorldTile(position).GetID();
-  return id == TileID::kInvisibleBarrier ||
-         (id >= TileID::kDirtTopLeft && id <= TileID::kDirtBottomRight) ||
-         (id >= TileID::kStoneHorizontalLeft &&
-          id <= TileID::kStoneVerticalBottom) ||
-         id == TileID::kPlasticBlock;
-}
-
-}  // namespace
-
 static constexpr int32_t kAnimationTPF = 4;
+static constexpr sf::Vector2i kFrameSize = {32, 32};
 
 Mushroom::RunState::RunState(ng::State<Context>::ID id,
                              ng::SpriteSheetAnimation animation)
@@ -56,14 +46,17 @@ Mushroom::HitState::HitState(ng::State<Context>::ID id,
                              ng::Node* node)
     : ng::State<Context>(std::move(id)),
       animation_(std::move(animation)),
-      sound_(*sound_buffer),
+      sound_buffer_(sound_buffer),
       node_(node) {
   animation_.RegisterOnEndCallback([this]() -> void { Die(); });
 }
 
 void Mushroom::HitState::OnEnter() {
   animation_.Start();
-  sound_.play();
+  if (!sound_) {
+    sound_.emplace(*sound_buffer_);
+  }
+  sound_->play();
 }
 
 void Mushroom::HitState::Update() {
@@ -84,13 +77,14 @@ Mushroom::Mushroom(ng::App* app, const ng::Tilemap* tilemap)
                                           &sprite_, &sprite_.getTexture(),
                                           kAnimationTPF))) {
   SetName("Mushroom");
+  SetDrawnDirectly(false);
 
-  sprite_.setScale({2, 2});
-  sprite_.setOrigin({16, 16});
-  sprite_.setTextureRect(sf::IntRect({0, 0}, {32, 32}));
+  SetUpSpriteFrame(sprite_, kFrameSize);
 
   auto& collider = MakeChild<ng::RectangleCollider>(sf::Vector2f(32, 32));
   collider.SetLocalPosition({0, 16});
+  collider.SetCollisionCategory(kEnemyLayer);
+  collider.SetCollisionMask(kPlayerLayer | kEnemyLayer);
   collider_ = &collider;
 
   animator_.AddState(std::make_unique<HitState>(
@@ -115,7 +109,7 @@ void Mushroom::TakeDamage() {
   context_.is_dead = true;
 }
 
-void Mushroom::Update() {  // NOLINT
+void Mushroom::Update() {
   animator_.Update();
 
   if (context_.is_dead) {
@@ -126,112 +120,64 @@ void Mushroom::Update() {  // NOLINT
   velocity_.x = direction_.x * kMovementSpeed;
   velocity_.y += 1;
 
-  sf::Vector2f old_pos = collider_->GetGlobalTransform().getPosition();
-  sf::Vector2f new_pos = old_pos + velocity_;
-
   sf::Vector2f col_half_size = collider_->GetSize() / 2.F;
-  sf::Vector2f tilemap_size = sf::Vector2f(tilemap_->GetTileSize());
+  ng::TileMoveResult move = tilemap_->MoveAndCollide(
+      {collider_->GetGlobalPosition() - col_half_size, collider_->GetSize()},
+      velocity_);
 
-  static constexpr float kEps = 0.001F;
-  sf::Vector2f top_left = {new_pos.x - (col_half_size.x - kEps),
-                           old_pos.y - (col_half_size.y - kEps)};
-  sf::Vector2f bottom_left = {new_pos.x - (col_half_size.x - kEps),
-                              old_pos.y + (col_half_size.y - kEps)};
-
-  if (!tilemap_->IsWithinWorldBounds(top_left) ||
-      !tilemap_->IsWithinWorldBounds(bottom_left)) {
+  if (move.is_out_of_bounds) {
     TakeDamage();
     return;
   }
 
-  if (velocity_.x < 0 && (DoesCollide(top_left, *tilemap_) ||
-                          DoesCollide(bottom_left, *tilemap_))) {
-    new_pos.x = std::ceil(top_left.x / tilemap_size.x) * tilemap_size.x +
-                col_half_size.x;
-    velocity_.x = 0;
+  // Mushrooms turn around when they run into a wall.
+  if (move.hit_left) {
     direction_.x = 1;
-  }
-
-  sf::Vector2f top_right = {new_pos.x + (col_half_size.x - kEps),
-                            old_pos.y - (col_half_size.y - kEps)};
-  sf::Vector2f bottom_right = {new_pos.x + (col_half_size.x - kEps),
-                               old_pos.y + (col_half_size.y - kEps)};
-
-  if (!tilemap_->IsWithinWorldBounds(top_right) ||
-      !tilemap_->IsWithinWorldBounds(bottom_right)) {
-    TakeDamage();
-    return;
-  }
-
-  if (velocity_.x > 0 && (DoesCollide(top_right, *tilemap_) ||
-                          DoesCollide(bottom_right, *tilemap_))) {
-    new_pos.x = std::floor(top_right.x / tilemap_size.x) * tilemap_size.x -
-                col_half_size.x;
-    velocity_.x = 0;
+  } else if (move.hit_right) {
     direction_.x = -1;
   }
 
-  top_left = {new_pos.x - (col_half_size.x - kEps),
-              new_pos.y - (col_half_size.y - kEps)};
-  top_right = {new_pos.x + (col_half_size.x - kEps),
-               new_pos.y - (col_half_size.y - kEps)};
+  velocity_ = move.velocity;
+  is_on_ground_ = move.hit_bottom;
 
-  if (!tilemap_->IsWithinWorldBounds(top_left) ||
-      !tilemap_->IsWithinWorldBounds(top_right)) {
-    TakeDamage();
-    return;
-  }
+  sf::Vector2f new_pos = move.bounds.position + col_half_size;
+  SetLocalPosition(new_pos - collider_->GetLocalTransform().getPosition());
+}
 
-  if (velocity_.y < 0 &&
-      (DoesCollide(top_left, *tilemap_) || DoesCollide(top_right, *tilemap_))) {
-    new_pos.y = std::ceil(top_left.y / tilemap_size.y) * tilemap_size.y +
-                col_half_size.y;
-    velocity_.y = 0;
-  }
+void Mushroom::OnCollisionEnter([[maybe_unused]] const ng::Collider& collider,
+                               const ng::Collider& other) {
+  HandleCollision(other);
+}
 
-  bottom_left = {new_pos.x - (col_half_size.x - kEps),
-                 new_pos.y + (col_half_size.y - kEps)};
-  bottom_right = {new_pos.x + (col_half_size.x - kEps),
-                  new_pos.y + (col_half_size.y - kEps)};
+void Mushroom::OnCollisionStay([[maybe_unused]] const ng::Collider& collider,
+                              const ng::Collider& other) {
+  HandleCollision(other);
+}
 
-  if (!tilemap_->IsWithinWorldBounds(bottom_left) ||
-      !tilemap_->IsWithinWorldBounds(bottom_right)) {
-    TakeDamage();
+void Mushroom::HandleCollision(const ng::Collider& other) {
+  if (context_.is_dead) {
     return;
   }
 
-  if (velocity_.y > 0 && (DoesCollide(bottom_left, *tilemap_) ||
-                          DoesCollide(bottom_right, *tilemap_))) {
-    new_pos.y = std::floor(bottom_left.y / tilemap_size.y) * tilemap_size.y -
-                col_half_size.y;
-    velocity_.y = 0;
-    is_on_ground_ = true;
-  } else {
-    is_on_ground_ = false;
-  }
-
-  SetLocalPosition(new_pos - collider_->GetLocalTransform().getPosition());
-
-  std::vector<const ng::Collider*> others =
-      GetScene()->GetPhysics().Overlap(*collider_);
-  for (const auto* other : others) {
-    if (other->GetParent()->GetName() == "Player") {
-      auto* player = dynamic_cast<Player*>(other->GetParent());
-      if (player->GetVelocity().y <= 0) {
-        player->TakeDamage();
-      }
-    } else if (other->GetParent()->GetName() == "Mushroom") {
-      auto* mushroom = dynamic_cast<Mushroom*>(other->GetParent());
-      if (!mushroom->GetIsDead()) {
-        direction_.x = -direction_.x;
-      }
+  ng::Node* other_parent = other.GetParent();
+  if (auto* player = other_parent->As<Player>()) {
+    if (player->GetVelocity().y <= 0) {
+      player->TakeDamage();
+    }
+  } else if (auto* mushroom = other_parent->As<Mushroom>()) {
+    if (!mushroom->GetIsDead()) {
+      direction_.x = -direction_.x;
     }
   }
 }
 
-void Mushroom::Draw(sf::RenderTarget& target) {
-  sprite_.setScale(sf::Vector2f{-direction_.x * 2, 2.F});
-  target.draw(sprite_, GetGlobalTransform().getTransform());
+std::optional<sf::FloatRect> Mushroom::GetLocalBounds() const {
+  return GetSpriteFrameBounds(kFrameSize);
+}
+
+void Mushroom::Draw([[maybe_unused]] sf::RenderTarget& target) {
+  sprite_.setScale(sf::Vector2f{-direction_.x * kSpriteScale, kSpriteScale});
+  GetScene()->GetSpriteBatch().Draw(sprite_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
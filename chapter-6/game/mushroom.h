@@ -1,9 +1,11 @@
 #pragma once
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <optional>
 
 #include "engine/app.h"
 #include "engine/fsm.h"
@@ -20,10 +22,15 @@ class Mushroom : public ng::Node {
   Mushroom(ng::App* app, const ng::Tilemap* tilemap);
   bool GetIsDead() const;
   void TakeDamage();
+  std::optional<sf::FloatRect> GetLocalBounds() const override;
 
  protected:
   void Update() override;
   void Draw(sf::RenderTarget& target) override;
+  void OnCollisionEnter(const ng::Collider& collider,
+                        const ng::Collider& other) override;
+  void OnCollisionStay(const ng::Collider& collider,
+                       const ng::Collider& other) override;
 
  private:
   struct Context {
@@ -57,10 +64,14 @@ class Mushroom : public ng::Node {
     void Die();
 
     ng::SpriteSheetAnimation animation_;
-    sf::Sound sound_;
+    const sf::SoundBuffer* sound_buffer_ = nullptr;
+    // Created on the first entry, on the main thread.
+    std::optional<sf::Sound> sound_;
     ng::Node* node_ = nullptr;
   };
 
+  void HandleCollision(const ng::Collider& other);
+
   sf::Vector2f direction_{-1, 0};
   sf::Vector2f velocity_;
   const ng::Tilemap* tilemap_ = nullptr;
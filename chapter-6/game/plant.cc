@@ -1,28 +1,33 @@
 #include "plant.h"
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
-#include <vector>
 
+#include "collision_layer.h"
 #include "engine/app.h"
 #include "engine/collider.h"
 #include "engine/node.h"
 #include "engine/rectangle_collider.h"
+#include "engine/scene.h"
 #include "engine/sprite_sheet_animation.h"
 #include "engine/state.h"
 #include "engine/tilemap.h"
 #include "engine/transition.h"
 #include "plant_bullet.h"
 #include "player.h"
+#include "sprite_frame.h"
 
 namespace game {
 
 static constexpr int32_t kAnimationTPF = 4;
+static constexpr sf::Vector2i kFrameSize = {44, 42};
 
 Plant::IdleState::IdleState(ng::State<Context>::ID id,
                             ng::SpriteSheetAnimation animation)
@@ -72,14 +77,17 @@ Plant::HitState::HitState(ng::State<Context>::ID id,
                           const sf::SoundBuffer* sound_buffer, Plant* plant)
     : ng::State<Context>(std::move(id)),
       animation_(std::move(animation)),
-      sound_(*sound_buffer),
+      sound_buffer_(sound_buffer),
       plant_(plant) {
   animation_.RegisterOnEndCallback([this]() { Die(); });
 }
 
 void Plant::HitState::OnEnter() {
   animation_.Start();
-  sound_.play();
+  if (!sound_) {
+    sound_.emplace(*sound_buffer_);
+  }
+  sound_->play();
 }
 
 void Plant::HitState::Update() {
@@ -98,14 +106,15 @@ Plant::Plant(ng::App* app, const ng::Tilemap* tilemap)
       animator_(&context_, std::make_unique<IdleState>(
                                "idle", ng::SpriteSheetAnimation(
                                            &sprite_, &sprite_.getTexture(),
-                                           kAnimationTPF, {44, 42}))) {
+                                           kAnimationTPF, kFrameSize))) {
   SetName("Plant");
-  sprite_.setScale({2, 2});
-  sprite_.setOrigin({22, 21});
-  sprite_.setTextureRect(sf::IntRect({0, 0}, {44, 42}));
+  SetDrawnDirectly(false);
+  SetUpSpriteFrame(sprite_, kFrameSize);
 
   auto& collider = MakeChild<ng::RectangleCollider>(sf::Vector2f(40, 42));
   collider.SetLocalPosition({8, 0});
+  collider.SetCollisionCategory(kEnemyLayer);
+  collider.SetCollisionMask(kPlayerLayer);
   collider_ = &collider;
 
   animator_.AddState(std::make_unique<AttackState>(
@@ -113,14 +122,14 @@ Plant::Plant(ng::App* app, const ng::Tilemap* tilemap)
       ng::SpriteSheetAnimation(&sprite_,
                                &GetApp()->GetResourceManager().LoadTexture(
                                    "Plant/Attack (44x42).png"),
-                               kAnimationTPF, {44, 42}),
+                               kAnimationTPF, kFrameSize),
       this, tilemap_, direction_));
   animator_.AddState(std::make_unique<HitState>(
       "hit",
       ng::SpriteSheetAnimation(
           &sprite_,
           &GetApp()->GetResourceManager().LoadTexture("Plant/Hit (44x42).png"),
-          kAnimationTPF, {44, 42}),
+          kAnimationTPF, kFrameSize),
       &GetApp()->GetResourceManager().LoadSoundBuffer("Mushroom/Hit_2.wav"),
       this));
 
@@ -160,22 +169,37 @@ void Plant::Update() {
     context_.is_attacking = true;
     attack_timer_ = kAttackCooldown;
   }
+}
+
+void Plant::OnCollisionEnter([[maybe_unused]] const ng::Collider& collider,
+                            const ng::Collider& other) {
+  HandleCollision(other);
+}
+
+void Plant::OnCollisionStay([[maybe_unused]] const ng::Collider& collider,
+                           const ng::Collider& other) {
+  HandleCollision(other);
+}
+
+void Plant::HandleCollision(const ng::Collider& other) {
+  if (context_.is_dead) {
+    return;
+  }
 
-  std::vector<const ng::Collider*> others =
-      GetScene()->GetPhysics().Overlap(*collider_);
-  for (const auto* other : others) {
-    if (other->GetParent()->GetName() == "Player") {
-      auto* player = dynamic_cast<Player*>(other->GetParent());
-      if (player->GetVelocity().y <= 0) {
-        player->TakeDamage();
-      }
+  if (auto* player = other.GetParent()->As<Player>()) {
+    if (player->GetVelocity().y <= 0) {
+      player->TakeDamage();
     }
   }
 }
 
-void Plant::Draw(sf::RenderTarget& target) {
-  sprite_.setScale(sf::Vector2f{-direction_.x * 2, 2.F});
-  target.draw(sprite_, GetGlobalTransform().getTransform());
+std::optional<sf::FloatRect> Plant::GetLocalBounds() const {
+  return GetSpriteFrameBounds(kFrameSize);
+}
+
+void Plant::Draw([[maybe_unused]] sf::RenderTarget& target) {
+  sprite_.setScale(sf::Vector2f{-direction_.x * kSpriteScale, kSpriteScale});
+  GetScene()->GetSpriteBatch().Draw(sprite_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
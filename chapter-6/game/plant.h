@@ -1,10 +1,12 @@
 #pragma once
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <cstdint>
+#include <optional>
 
 #include "engine/fsm.h"
 #include "engine/node.h"
@@ -19,10 +21,15 @@ class Plant : public ng::Node {
   Plant(ng::App* app, const ng::Tilemap* tilemap);
   bool GetIsDead() const;
   void TakeDamage();
+  std::optional<sf::FloatRect> GetLocalBounds() const override;
 
  protected:
   void Update() override;
   void Draw(sf::RenderTarget& target) override;
+  void OnCollisionEnter(const ng::Collider& collider,
+                        const ng::Collider& other) override;
+  void OnCollisionStay(const ng::Collider& collider,
+                       const ng::Collider& other) override;
 
  private:
   struct Context {
@@ -77,10 +84,14 @@ class Plant : public ng::Node {
     void Die();
 
     ng::SpriteSheetAnimation animation_;
-    sf::Sound sound_;
+    const sf::SoundBuffer* sound_buffer_ = nullptr;
+    // Created on the first entry, on the main thread.
+    std::optional<sf::Sound> sound_;
     Plant* plant_ = nullptr;
   };
 
+  void HandleCollision(const ng::Collider& other);
+
   sf::Vector2f direction_{-1, 0};
   const ng::Tilemap* tilemap_ = nullptr;
   const ng::RectangleCollider* collider_ = nullptr;
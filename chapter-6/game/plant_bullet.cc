@@ -1,19 +1,25 @@
 #include "plant_bullet.h"
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/System/Vector2.hpp>
-#include <vector>
+#include <optional>
 
+#include "collision_layer.h"
 #include "engine/app.h"
 #include "engine/circle_collider.h"
 #include "engine/collider.h"
 #include "engine/node.h"
+#include "engine/physics.h"
+#include "engine/scene.h"
 #include "engine/tilemap.h"
 #include "player.h"
-#include "tile_id.h"
+#include "sprite_frame.h"
 
 namespace game {
 
+static constexpr sf::Vector2i kFrameSize = {16, 16};
+
 PlantBullet::PlantBullet(ng::App* app, const ng::Tilemap* tilemap,
                          sf::Vector2f direction)
     : ng::Node(app),
@@ -21,11 +27,12 @@ PlantBullet::PlantBullet(ng::App* app, const ng::Tilemap* tilemap,
       direction_(direction),
       sprite_(GetApp()->GetResourceManager().LoadTexture("Plant/Bullet.png")) {
   SetName("PlantBullet");
-  sprite_.setScale({2, 2});
-  sprite_.setOrigin({8, 8});
-  sprite_.setTextureRect(sf::IntRect({0, 0}, {16, 16}));
+  SetDrawnDirectly(false);
+  SetUpSpriteFrame(sprite_, kFrameSize);
 
   auto& collider = MakeChild<ng::CircleCollider>(4.F);
+  collider.SetCollisionCategory(kEnemyProjectileLayer);
+  collider.SetCollisionMask(kPlayerLayer);
   collider_ = &collider;
 }
 
@@ -33,53 +40,49 @@ bool PlantBullet::GetIsDead() const {
   return is_dead_;
 }
 
-namespace {
-
-bool DoesCollide(sf::Vector2f position, const ng::Tilemap& tilemap) {
-  TileID id = tilemap.GetWorldTile(position).GetID();
-  return id == TileID::kInvisibleBarrier ||
-         (id >= TileID::kDirtTopLeft && id <= TileID::kDirtBottomRight) ||
-         (id >= TileID::kStoneHorizontalLeft &&
-          id <= TileID::kStoneVerticalBottom) ||
-         id == TileID::kPlasticBlock;
-}
-
-}  // namespace
-
 void PlantBullet::Update() {
   if (is_dead_) {
     return;
   }
 
-  sf::Vector2f pos = GetGlobalTransform().getPosition();
+  sf::Vector2f pos = GetGlobalPosition();
   if (!tilemap_->IsWithinWorldBounds(pos)) {
     is_dead_ = true;
     Destroy();
     return;
   }
 
-  if (DoesCollide(pos, *tilemap_)) {
+  // The whole move is swept rather than only its end tested, so that bullets
+  // cannot pass through thin walls or the player however fast they are.
+  static constexpr float kMovementSpeed = 6;
+  sf::Vector2f displacement = direction_ * kMovementSpeed;
+  std::optional<ng::TileSweepHit> wall_hit =
+      tilemap_->Sweep(collider_->GetGlobalShape(), displacement);
+  float wall_time = wall_hit ? wall_hit->time : 1.F;
+  std::optional<ng::ColliderSweepHit> hit =
+      GetScene()->GetPhysics().Sweep(*collider_, displacement);
+  if (hit && hit->time <= wall_time) {
+    if (auto* player = hit->collider->GetParent()->As<Player>()) {
+      player->TakeDamage();
+    }
+  }
+
+  if (wall_hit) {
     is_dead_ = true;
     Destroy();
     return;
   }
 
-  static constexpr float kMovementSpeed = 6;
-  Translate(direction_ * kMovementSpeed);
+  Translate(displacement);
+}
 
-  std::vector<const ng::Collider*> others =
-      GetScene()->GetPhysics().Overlap(*collider_);
-  for (const auto* other : others) {
-    if (other->GetParent()->GetName() == "Player") {
-      auto* player = dynamic_cast<Player*>(other->GetParent());
-      player->TakeDamage();
-    }
-  }
+std::optional<sf::FloatRect> PlantBullet::GetLocalBounds() const {
+  return GetSpriteFrameBounds(kFrameSize);
 }
 
-void PlantBullet::Draw(sf::RenderTarget& target) {
-  sprite_.setScale(sf::Vector2f{-direction_.x * 2, 2.F});
-  target.draw(sprite_, GetGlobalTransform().getTransform());
+void PlantBullet::Draw([[maybe_unused]] sf::RenderTarget& target) {
+  sprite_.setScale(sf::Vector2f{-direction_.x * kSpriteScale, kSpriteScale});
+  GetScene()->GetSpriteBatch().Draw(sprite_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <optional>
 
 #include "engine/circle_collider.h"
 #include "engine/node.h"
@@ -15,6 +17,7 @@ class PlantBullet : public ng::Node {
   PlantBullet(ng::App* app, const ng::Tilemap* tilemap, sf::Vector2f direction);
 
   bool GetIsDead() const;
+  std::optional<sf::FloatRect> GetLocalBounds() const override;
 
  protected:
   void Update() override;
@@ -1,17 +1,18 @@
 #include "player.h"
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <SFML/Window/Keyboard.hpp>
-#include <cmath>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <utility>
-#include <vector>
 
 #include "banana.h"
+#include "collision_layer.h"
 #include "end.h"
 #include "engine/app.h"
 #include "engine/collider.h"
@@ -20,6 +21,7 @@
 #include "engine/node.h"
 #include "engine/rectangle_collider.h"
 #include "engine/resource_manager.h"
+#include "engine/scene.h"
 #include "engine/sprite_sheet_animation.h"
 #include "engine/state.h"
 #include "engine/tilemap.h"
@@ -28,24 +30,13 @@
 #include "mushroom.h"
 #include "plant.h"
 #include "score_manager.h"
+#include "sprite_frame.h"
 #include "tile_id.h"
 
 namespace game {
 
-namespace {
-
-bool DoesCollide(sf::Vector2f position, const ng::Tilemap& tilemap) {
-  TileID id = tilemap.GetWorldTile(position).GetID();
-  return id == TileID::kInvisibleBarrier ||
-         (id >= TileID::kDirtTopLeft && id <= TileID::kDirtBottomRight) ||
-         (id >= TileID::kStoneHorizontalLeft &&
-          id <= TileID::kStoneVerticalBottom) ||
-         id == TileID::kPlasticBlock;
-}
-
-}  // namespace
-
 static constexpr int32_t kAnimationTPF = 4;
+static constexpr sf::Vector2i kFrameSize = {32, 32};
 
 Player::IdleState::IdleState(ng::State<Context>::ID id,
                              ng::SpriteSheetAnimation animation)
@@ -76,11 +67,14 @@ Player::JumpState::JumpState(ng::State<Context>::ID id,
                              const sf::SoundBuffer* sound_buffer)
     : ng::State<Context>(std::move(id)),
       animation_(std::move(animation)),
-      sound_(*sound_buffer) {}
+      sound_buffer_(sound_buffer) {}
 
 void Player::JumpState::OnEnter() {
   animation_.Start();
-  sound_.play();
+  if (!sound_) {
+    sound_.emplace(*sound_buffer_);
+  }
+  sound_->play();
 }
 
 void Player::JumpState::Update() {
@@ -133,19 +127,17 @@ Player::Player(ng::App* app, ng::Tilemap* tilemap, GameManager* game_manager,
       animator_(&context_, std::make_unique<IdleState>(
                                "idle", ng::SpriteSheetAnimation(
                                            &sprite_, &sprite_.getTexture(),
-                                           kAnimationTPF))),
-      plastic_block_sound_(
-          GetApp()->GetResourceManager().LoadSoundBuffer("Hit_1.wav")),
-      banana_sound_(GetApp()->GetResourceManager().LoadSoundBuffer(
-          "Banana/Collectibles_2.wav")) {
+                                           kAnimationTPF))) {
   SetName("Player");
+  SetDrawnDirectly(false);
 
-  sprite_.setScale({2, 2});
-  sprite_.setOrigin({16, 16});
-  sprite_.setTextureRect(sf::IntRect({0, 0}, {32, 32}));
+  SetUpSpriteFrame(sprite_, kFrameSize);
 
   auto& collider = MakeChild<ng::RectangleCollider>(sf::Vector2f(32, 48));
   collider.SetLocalPosition({0, 8});
+  collider.SetCollisionCategory(kPlayerLayer);
+  collider.SetCollisionMask(kEnemyLayer | kEnemyProjectileLayer |
+                            kPickupLayer | kGoalLayer);
   collider_ = &collider;
 
   animator_.AddState(std::make_unique<RunState>(
@@ -223,6 +215,13 @@ void Player::TakeDamage() {
   context_.is_dead = true;
 }
 
+void Player::OnAdd() {
+  plastic_block_sound_.emplace(
+      GetApp()->GetResourceManager().LoadSoundBuffer("Hit_1.wav"));
+  banana_sound_.emplace(GetApp()->GetResourceManager().LoadSoundBuffer(
+      "Banana/Collectibles_2.wav"));
+}
+
 void Player::Update() {  // NOLINT
   animator_.Update();
 
@@ -234,11 +233,11 @@ void Player::Update() {  // NOLINT
   if (!has_won_) {
     if (GetApp()->GetInput().GetKey(sf::Keyboard::Scancode::A)) {
       direction.x += -1;
-      sprite_.setScale(sf::Vector2f{-2.F, 2.F});
+      sprite_.setScale(sf::Vector2f{-kSpriteScale, kSpriteScale});
     }
     if (GetApp()->GetInput().GetKey(sf::Keyboard::Scancode::D)) {
       direction.x += 1;
-      sprite_.setScale(sf::Vector2f{2.F, 2.F});
+      sprite_.setScale(sf::Vector2f{kSpriteScale, kSpriteScale});
     }
   }
 
@@ -251,150 +250,90 @@ void Player::Update() {  // NOLINT
     context_.velocity.y -= 15;
   }
 
-  sf::Vector2f old_pos = collider_->GetGlobalTransform().getPosition();
-  sf::Vector2f new_pos = old_pos + context_.velocity;
-
   sf::Vector2f col_half_size = collider_->GetSize() / 2.F;
-  sf::Vector2f tilemap_size = sf::Vector2f(tilemap_->GetTileSize());
-
-  static constexpr float kEps = 0.001F;
-  sf::Vector2f top_left = {new_pos.x - (col_half_size.x - kEps),
-                           old_pos.y - (col_half_size.y - kEps)};
-  sf::Vector2f middle_left = {new_pos.x + (col_half_size.x - kEps),
-                              old_pos.y + (0 - kEps)};
-  sf::Vector2f bottom_left = {new_pos.x - (col_half_size.x - kEps),
-                              old_pos.y + (col_half_size.y - kEps)};
-
-  if (!tilemap_->IsWithinWorldBounds(top_left) ||
-      !tilemap_->IsWithinWorldBounds(middle_left) ||
-      !tilemap_->IsWithinWorldBounds(bottom_left)) {
-    TakeDamage();
-    return;
-  }
+  ng::TileMoveResult move = tilemap_->MoveAndCollide(
+      {collider_->GetGlobalPosition() - col_half_size, collider_->GetSize()},
+      context_.velocity);
 
-  if (context_.velocity.x < 0 && (DoesCollide(top_left, *tilemap_) ||
-                                  DoesCollide(middle_left, *tilemap_) ||
-                                  DoesCollide(bottom_left, *tilemap_))) {
-    new_pos.x = std::ceil(top_left.x / tilemap_size.x) * tilemap_size.x +
-                col_half_size.x;
-    context_.velocity.x = 0;
-  }
-
-  sf::Vector2f top_right = {new_pos.x + (col_half_size.x - kEps),
-                            old_pos.y - (col_half_size.y - kEps)};
-  sf::Vector2f middle_right = {new_pos.x + (col_half_size.x - kEps),
-                               old_pos.y + (0 - kEps)};
-  sf::Vector2f bottom_right = {new_pos.x + (col_half_size.x - kEps),
-                               old_pos.y + (col_half_size.y - kEps)};
-
-  if (!tilemap_->IsWithinWorldBounds(top_right) ||
-      !tilemap_->IsWithinWorldBounds(middle_right) ||
-      !tilemap_->IsWithinWorldBounds(bottom_right)) {
+  if (move.is_out_of_bounds) {
     TakeDamage();
     return;
   }
 
-  if (context_.velocity.x > 0 && (DoesCollide(top_right, *tilemap_) ||
-                                  DoesCollide(middle_right, *tilemap_) ||
-                                  DoesCollide(bottom_right, *tilemap_))) {
-    new_pos.x = std::floor(top_right.x / tilemap_size.x) * tilemap_size.x -
-                col_half_size.x;
-    context_.velocity.x = 0;
-  }
-
-  top_left = {new_pos.x - (col_half_size.x - kEps),
-              new_pos.y - (col_half_size.y - kEps)};
-  top_right = {new_pos.x + (col_half_size.x - kEps),
-               new_pos.y - (col_half_size.y - kEps)};
-
-  if (!tilemap_->IsWithinWorldBounds(top_left) ||
-      !tilemap_->IsWithinWorldBounds(top_right)) {
-    TakeDamage();
-    return;
+  if (move.hit_top) {
+    // Plastic blocks break when hit from below.
+    static constexpr float kEps = 0.001F;
+    float above = move.bounds.position.y - kEps;
+    for (float x : {move.bounds.position.x + kEps,
+                    move.bounds.position.x + move.bounds.size.x - kEps}) {
+      if (tilemap_->GetWorldTile({x, above}).GetID() ==
+          TileID::kPlasticBlock) {
+        tilemap_->SetWorldTile({x, above}, TileID::kVoid);
+        plastic_block_sound_->play();
+      }
+    }
   }
 
-  if (context_.velocity.y < 0 &&
-      (DoesCollide(top_left, *tilemap_) || DoesCollide(top_right, *tilemap_))) {
-    {
-      if (tilemap_->GetWorldTile(top_left).GetID() == TileID::kPlasticBlock) {
-        tilemap_->SetWorldTile(top_left, TileID::kVoid);
-        plastic_block_sound_.play();
-      }
+  context_.velocity = move.velocity;
+  context_.is_on_ground = move.hit_bottom;
 
-      if (tilemap_->GetWorldTile(top_right).GetID() == TileID::kPlasticBlock) {
-        tilemap_->SetWorldTile(top_right, TileID::kVoid);
-        plastic_block_sound_.play();
-      }
-    }
+  sf::Vector2f new_pos = move.bounds.position + col_half_size;
+  SetLocalPosition(new_pos - collider_->GetLocalTransform().getPosition());
+}
 
-    new_pos.y = std::ceil(top_left.y / tilemap_size.y) * tilemap_size.y +
-                col_half_size.y;
-    context_.velocity.y = 0;
-  }
+void Player::OnCollisionEnter([[maybe_unused]] const ng::Collider& collider,
+                             const ng::Collider& other) {
+  HandleCollision(other);
+}
 
-  bottom_left = {new_pos.x - (col_half_size.x - kEps),
-                 new_pos.y + (col_half_size.y - kEps)};
-  bottom_right = {new_pos.x + (col_half_size.x - kEps),
-                  new_pos.y + (col_half_size.y - kEps)};
+void Player::OnCollisionStay([[maybe_unused]] const ng::Collider& collider,
+                            const ng::Collider& other) {
+  HandleCollision(other);
+}
 
-  if (!tilemap_->IsWithinWorldBounds(bottom_left) ||
-      !tilemap_->IsWithinWorldBounds(bottom_right)) {
-    TakeDamage();
+void Player::HandleCollision(const ng::Collider& other) {
+  if (context_.is_dead) {
     return;
   }
 
-  if (context_.velocity.y > 0 && (DoesCollide(bottom_left, *tilemap_) ||
-                                  DoesCollide(bottom_right, *tilemap_))) {
-    new_pos.y = std::floor(bottom_left.y / tilemap_size.y) * tilemap_size.y -
-                col_half_size.y;
-    context_.velocity.y = 0;
-    context_.is_on_ground = true;
-  } else {
-    context_.is_on_ground = false;
-  }
-
-  SetLocalPosition(new_pos - collider_->GetLocalTransform().getPosition());
-
-  std::vector<const ng::Collider*> others =
-      GetScene()->GetPhysics().Overlap(*collider_);
-  for (const auto* other : others) {
-    if (other->GetParent()->GetName() == "Mushroom") {
-      if (context_.velocity.y > 0) {
-        auto* mushroom = dynamic_cast<Mushroom*>(other->GetParent());
-        if (!mushroom->GetIsDead()) {
-          mushroom->TakeDamage();
-          context_.velocity.y = -10;
-          score_manager_->AddScore(100);
-        }
-      }
-    } else if (other->GetParent()->GetName() == "Plant") {
-      if (context_.velocity.y > 0) {
-        auto* plant = dynamic_cast<Plant*>(other->GetParent());
-        if (!plant->GetIsDead()) {
-          plant->TakeDamage();
-          context_.velocity.y = -10;
-          score_manager_->AddScore(150);
-        }
-      }
-    } else if (other->GetParent()->GetName() == "Banana") {
-      auto* banana = dynamic_cast<Banana*>(other->GetParent());
-      if (!banana->GetIsCollected()) {
-        banana->Collect();
-        score_manager_->AddScore(500);
-        banana_sound_.play();
+  ng::Node* other_parent = other.GetParent();
+  if (auto* mushroom = other_parent->As<Mushroom>()) {
+    if (context_.velocity.y > 0) {
+      if (!mushroom->GetIsDead()) {
+        mushroom->TakeDamage();
+        context_.velocity.y = -10;
+        score_manager_->AddScore(100);
       }
-    } else if (other->GetParent()->GetName() == "End") {
-      if (!has_won_) {
-        context_.velocity.y = -15;
-        dynamic_cast<End*>(other->GetParent())->EndGame();
-        has_won_ = true;
+    }
+  } else if (auto* plant = other_parent->As<Plant>()) {
+    if (context_.velocity.y > 0) {
+      if (!plant->GetIsDead()) {
+        plant->TakeDamage();
+        context_.velocity.y = -10;
+        score_manager_->AddScore(150);
       }
     }
+  } else if (auto* banana = other_parent->As<Banana>()) {
+    if (!banana->GetIsCollected()) {
+      banana->Collect();
+      score_manager_->AddScore(500);
+      banana_sound_->play();
+    }
+  } else if (auto* end = other_parent->As<End>()) {
+    if (!has_won_) {
+      context_.velocity.y = -15;
+      end->EndGame();
+      has_won_ = true;
+    }
   }
 }
 
-void Player::Draw(sf::RenderTarget& target) {
-  target.draw(sprite_, GetGlobalTransform().getTransform());
+std::optional<sf::FloatRect> Player::GetLocalBounds() const {
+  return GetSpriteFrameBounds(kFrameSize);
+}
+
+void Player::Draw([[maybe_unused]] sf::RenderTarget& target) {
+  GetScene()->GetSpriteBatch().Draw(sprite_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
@@ -1,10 +1,12 @@
 #pragma once
 
 #include <SFML/Audio/Sound.hpp>
+#include <SFML/Graphics/Rect.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Text.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <optional>
 
 #include "engine/fsm.h"
 #include "engine/node.h"
@@ -22,10 +24,16 @@ class Player : public ng::Node {
          ScoreManager* score_manager);
   sf::Vector2f GetVelocity() const;
   void TakeDamage();
+  std::optional<sf::FloatRect> GetLocalBounds() const override;
 
  protected:
+  void OnAdd() override;
   void Update() override;
   void Draw(sf::RenderTarget& target) override;
+  void OnCollisionEnter(const ng::Collider& collider,
+                        const ng::Collider& other) override;
+  void OnCollisionStay(const ng::Collider& collider,
+                       const ng::Collider& other) override;
 
  private:
   struct Context {
@@ -72,7 +80,9 @@ class Player : public ng::Node {
 
    private:
     ng::SpriteSheetAnimation animation_;
-    sf::Sound sound_;
+    const sf::SoundBuffer* sound_buffer_ = nullptr;
+    // Created on the first entry, on the main thread.
+    std::optional<sf::Sound> sound_;
   };
 
   class FallState : public ng::State<Context> {
@@ -106,6 +116,8 @@ class Player : public ng::Node {
     GameManager* game_manager_ = nullptr;
   };
 
+  void HandleCollision(const ng::Collider& other);
+
   ng::Tilemap* tilemap_ = nullptr;
   GameManager* game_manager_ = nullptr;
   ScoreManager* score_manager_ = nullptr;
@@ -114,8 +126,9 @@ class Player : public ng::Node {
   bool has_won_ = false;
   Context context_;
   ng::FSM<Context> animator_;
-  sf::Sound plastic_block_sound_;
-  sf::Sound banana_sound_;
+  // Created in OnAdd.
+  std::optional<sf::Sound> plastic_block_sound_;
+  std::optional<sf::Sound> banana_sound_;
 };
 
 }  // namespace game
\ No newline at end of file
@@ -15,7 +15,11 @@ ScoreManager::ScoreManager(ng::App* app)
       score_text_(
           GetApp()->GetResourceManager().LoadFont("Roboto-Regular.ttf")) {
   SetLayer(ng::Layer::kUI);
+}
 
+void ScoreManager::OnAdd() {
+  // Measuring the text renders its glyphs into the texture of the font, which
+  // must happen on the main thread.
   UpdateUI();
 }
 
@@ -30,7 +34,7 @@ void ScoreManager::Update() {
 }
 
 void ScoreManager::Draw(sf::RenderTarget& target) {
-  target.draw(score_text_, GetGlobalTransform().getTransform());
+  target.draw(score_text_, GetGlobalMatrix());
 }
 
 void ScoreManager::UpdateUI() {
@@ -15,6 +15,7 @@ class ScoreManager : public ng::Node {
   void AddScore(int32_t score);
 
  protected:
+  void OnAdd() override;
   void Update() override;
   void Draw(sf::RenderTarget& target) override;
 
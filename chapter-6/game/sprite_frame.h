@@ -0,0 +1,29 @@
+#pragma once
+
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <SFML/System/Vector2.hpp>
+
+namespace game {
+
+/// @brief How many times as large as their sprite sheet frames the game sprites are drawn.
+inline constexpr float kSpriteScale = 2.F;
+
+/// @brief Shows the first frame of the sprite sheet, centered on the node and drawn kSpriteScale times as large.
+/// @param sprite The sprite to set up.
+/// @param frame_size The size of each frame in the sprite sheet.
+inline void SetUpSpriteFrame(sf::Sprite& sprite, sf::Vector2i frame_size) {
+  sprite.setScale({kSpriteScale, kSpriteScale});
+  sprite.setOrigin(sf::Vector2f(frame_size) / 2.F);
+  sprite.setTextureRect(sf::IntRect({0, 0}, frame_size));
+}
+
+/// @brief Returns the local bounds of a sprite set up by SetUpSpriteFrame. They are the same for every frame and either facing, so that the cached world bounds stay valid as the animations and the direction change the sprite.
+/// @param frame_size The size of each frame in the sprite sheet.
+/// @return The bounds of the sprite, relative to the node.
+inline sf::FloatRect GetSpriteFrameBounds(sf::Vector2i frame_size) {
+  sf::Vector2f size = sf::Vector2f(frame_size) * kSpriteScale;
+  return {-size / 2.F, size};
+}
+
+}  // namespace game
\ No newline at end of file
@@ -18,6 +18,7 @@ WinCanvas::WinCanvas(ng::App* app)
           GetApp()->GetResourceManager().LoadFont("Roboto-Regular.ttf")) {
   SetName("WinCanvas");
   SetLayer(ng::Layer::kUI);
+  SetTickEnabled(false);
 
   background_.setFillColor(sf::Color(50, 50, 50, 200));
 
@@ -50,9 +51,9 @@ void WinCanvas::Draw(sf::RenderTarget& target) {
   background_.setSize(sf::Vector2f(GetApp()->GetWindow().getSize()));
   background_.setOrigin(sf::Vector2f(GetApp()->GetWindow().getSize()) / 2.F);
 
-  target.draw(background_, GetGlobalTransform().getTransform());
-  target.draw(title_text_, GetGlobalTransform().getTransform());
-  target.draw(restart_text_, GetGlobalTransform().getTransform());
+  target.draw(background_, GetGlobalMatrix());
+  target.draw(title_text_, GetGlobalMatrix());
+  target.draw(restart_text_, GetGlobalMatrix());
 }
 
 }  // namespace game
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "allocation_counter.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// The number of calls to the global operator new and operator new[].
+std::atomic<size_t> allocation_count = 0;
+
+/// @brief Allocates memory for the replaced operators, counting the allocation.
+/// @param size The number of bytes to allocate.
+/// @return The allocated memory. Never null.
+void* Allocate(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+}  // namespace
+
+namespace ng_test {
+
+size_t GetAllocationCount() {
+  return allocation_count.load(std::memory_order_relaxed);
+}
+
+}  // namespace ng_test
+
+// The whole family of the replaceable operators using the default alignment,
+// so that every deallocation matches its allocation. The nothrow forms call
+// these by default.
+void* operator new(size_t size) {
+  return Allocate(size);
+}
+
+void* operator new[](size_t size) {
+  return Allocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, [[maybe_unused]] size_t size) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory, [[maybe_unused]] size_t size) noexcept {
+  std::free(memory);
+}
\ No newline at end of file
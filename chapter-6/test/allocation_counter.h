@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ng_test {
+
+/// @brief Returns the number of calls to the global operator new and operator new[] since the start of the test program.
+///        The operators are replaced in their own translation unit, so that the compiler cannot inline them into the call sites.
+/// @return The number of allocations so far.
+size_t GetAllocationCount();
+
+}  // namespace ng_test
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "allocation_counter.h"
+#include "broadphase_param.h"
+#include "engine/app.h"
+#include "engine/circle_collider.h"
+#include "engine/collider.h"
+#include "engine/physics.h"
+#include "engine/rectangle_collider.h"
+#include "engine/scene.h"
+
+namespace {
+
+static constexpr uint32_t kTps = 60;
+// Enough colliders for the broadphases to return a fraction of them.
+static constexpr size_t kColliderCount = 300;
+static constexpr float kWorldSize = 800.F;
+// Enough ticks for every collider to visit all its positions, so that the
+// buffers of the physics world and the cells of the spatial hash have grown.
+static constexpr int kWarmUpTickCount = 30;
+static constexpr int kMeasuredTickCount = 30;
+
+/// @brief Checks that the physics world, once warmed up, neither ticks nor answers queries with heap allocations.
+class AllocationTest : public testing::TestWithParam<ng::PhysicsBroadphase> {
+ protected:
+  void SetUp() override {
+    auto scene = std::make_unique<ng::Scene>(&app_, GetParam());
+    scene_ = scene.get();
+    std::minstd_rand random(42);
+    std::uniform_real_distribution<float> coordinate(0.F, kWorldSize);
+    std::uniform_real_distribution<float> size(8.F, 48.F);
+    for (size_t i = 0; i < kColliderCount; ++i) {
+      ng::Collider* collider = nullptr;
+      if (i % 2 == 0) {
+        collider = &scene->MakeChild<ng::CircleCollider>(size(random) / 2);
+      } else {
+        collider = &scene->MakeChild<ng::RectangleCollider>(
+            sf::Vector2f(size(random), size(random)));
+      }
+      collider->SetLocalPosition({coordinate(random), coordinate(random)});
+      colliders_.push_back(collider);
+    }
+
+    app_.LoadScene(std::move(scene));
+    // Adds the colliders to the physics world.
+    app_.RunTicks(1);
+  }
+
+  /// @brief Moves a third of the colliders back and forth, then runs every overlap query for every collider and a tick.
+  /// @param tick The index of the tick, which selects the colliders moved and their direction.
+  void Tick(int tick) {
+    const ng::Physics& physics = scene_->GetPhysics();
+    float direction = tick % 2 == 0 ? 40.F : -40.F;
+    for (size_t i = static_cast<size_t>(tick / 2) % 3; i < colliders_.size();
+         i += 3) {
+      colliders_[i]->Translate({direction, 0.F});
+    }
+
+    for (const ng::Collider* collider : colliders_) {
+      overlaps_.clear();
+      physics.Overlap(*collider, overlaps_);
+      hit_count_ += physics.Overlap(*collider, std::span(buffer_));
+      physics.ForEachOverlap(*collider,
+                             [this](const ng::Collider&) { ++hit_count_; });
+      hit_count_ += physics.AnyOverlap(*collider) ? 1 : 0;
+      hit_count_ += physics.Sweep(*collider, {30.F, -20.F}) ? 1 : 0;
+    }
+
+    app_.RunTicks(1);
+  }
+
+  ng::App app_{kTps};
+  ng::Scene* scene_ = nullptr;
+  std::vector<ng::Collider*> colliders_;
+  // The buffers the queries write to, kept by the caller as the API intends.
+  std::vector<const ng::Collider*> overlaps_;
+  std::array<const ng::Collider*, 4> buffer_{};
+  // The number of results of the queries, checked once the allocations are counted.
+  size_t hit_count_ = 0;
+};
+
+TEST_P(AllocationTest, SteadyStateTicksAndQueriesDoNotAllocate) {
+  int tick = 0;
+  for (; tick < kWarmUpTickCount; ++tick) {
+    Tick(tick);
+  }
+
+  size_t allocations_before = ng_test::GetAllocationCount();
+  for (; tick < kWarmUpTickCount + kMeasuredTickCount; ++tick) {
+    Tick(tick);
+  }
+  EXPECT_EQ(ng_test::GetAllocationCount() - allocations_before, 0U);
+  EXPECT_GT(hit_count_, 0U);
+}
+
+INSTANTIATE_TEST_SUITE_P(Broadphases, AllocationTest,
+                         ng_test::kAllBroadphases,
+                         ng_test::GetBroadphaseName);
+
+}  // namespace
\ No newline at end of file
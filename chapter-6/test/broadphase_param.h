@@ -0,0 +1,33 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "engine/physics.h"
+
+namespace ng_test {
+
+/// @brief Every broadphase, for the tests that run against each of them.
+inline const auto kAllBroadphases =
+    testing::Values(ng::PhysicsBroadphase::kScan,
+                    ng::PhysicsBroadphase::kSpatialHash,
+                    ng::PhysicsBroadphase::kDynamicTree);
+
+/// @brief Names the instances of a test parameterized by broadphase.
+/// @param info The parameter of the test instance.
+/// @return The name of the broadphase of the instance.
+inline std::string GetBroadphaseName(
+    const testing::TestParamInfo<ng::PhysicsBroadphase>& info) {
+  switch (info.param) {
+    case ng::PhysicsBroadphase::kScan:
+      return "Scan";
+    case ng::PhysicsBroadphase::kSpatialHash:
+      return "SpatialHash";
+    case ng::PhysicsBroadphase::kDynamicTree:
+      return "DynamicTree";
+  }
+  return "";
+}
+
+}  // namespace ng_test
\ No newline at end of file
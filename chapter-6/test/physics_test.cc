@@ -0,0 +1,439 @@
+#include <gtest/gtest.h>
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <random>
+#include <set>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "broadphase_param.h"
+#include "engine/app.h"
+#include "engine/circle_collider.h"
+#include "engine/collider.h"
+#include "engine/collision_layer.h"
+#include "engine/node.h"
+#include "engine/physics.h"
+#include "engine/rectangle_collider.h"
+#include "engine/scene.h"
+#include "engine/sweep.h"
+
+namespace {
+
+static constexpr uint32_t kTps = 60;
+// Enough colliders for the broadphases to return a fraction of them.
+static constexpr size_t kColliderCount = 300;
+static constexpr float kWorldSize = 800.F;
+static constexpr int kRoundCount = 8;
+static constexpr ng::CollisionLayer kSecondLayer =
+    static_cast<ng::CollisionLayer>(1U << 1U);
+
+/// @brief Returns the distance from a point to a shape, 0 inside the shape.
+/// @param shape The world space shape.
+/// @param point The world space point.
+/// @return The distance from the point to the closest point of the shape.
+float GetDistance(const ng::ColliderShape& shape, sf::Vector2f point) {
+  if (shape.kind == ng::ColliderShape::Kind::kCircle) {
+    return std::max((point - shape.center).length() - shape.half_extents.x,
+                    0.F);
+  }
+
+  sf::Vector2f min = shape.center - shape.half_extents;
+  sf::Vector2f max = shape.center + shape.half_extents;
+  sf::Vector2f closest = {std::clamp(point.x, min.x, max.x),
+                          std::clamp(point.y, min.y, max.y)};
+  return (point - closest).length();
+}
+
+/// @brief A node recording the contacts of its child colliders through the collision callbacks.
+class ContactRecorder : public ng::Node {
+ public:
+  using ng::Node::Node;
+
+  // The contacts of the child colliders, as pairs of a child collider and the collider it overlaps.
+  std::set<std::pair<const ng::Collider*, const ng::Collider*>> contacts;
+
+ protected:
+  void OnCollisionEnter(const ng::Collider& collider,
+                        const ng::Collider& other) override {
+    contacts.insert({&collider, &other});
+  }
+
+  void OnCollisionExit(const ng::Collider& collider,
+                       const ng::Collider& other) override {
+    contacts.erase({&collider, &other});
+  }
+};
+
+/// @brief Runs the same scenario against every broadphase and compares the physics world with brute-force tests of every pair of colliders.
+class PhysicsTest : public testing::TestWithParam<ng::PhysicsBroadphase> {
+ protected:
+  void SetUp() override {
+    auto scene = std::make_unique<ng::Scene>(&app_, GetParam());
+    scene_ = scene.get();
+    recorder_ = &scene->MakeChild<ContactRecorder>();
+    for (size_t i = 0; i < kColliderCount; ++i) {
+      AddCollider();
+    }
+
+    app_.LoadScene(std::move(scene));
+    // Adds the colliders to the physics world.
+    app_.RunTicks(1);
+  }
+
+  /// @brief Adds a collider of random shape, size, position and layers, which joins the physics world on the next tick.
+  void AddCollider() {
+    std::uniform_real_distribution<float> size(8.F, 48.F);
+    ng::Collider* collider = nullptr;
+    if (random_() % 2 == 0) {
+      collider = &recorder_->MakeChild<ng::CircleCollider>(size(random_) / 2);
+    } else {
+      collider = &recorder_->MakeChild<ng::RectangleCollider>(
+          sf::Vector2f(size(random_), size(random_)));
+    }
+    collider->SetLocalPosition(GetRandomPoint());
+    if (random_() % 4 == 0) {
+      collider->SetCollisionCategory(kSecondLayer);
+    }
+    if (random_() % 5 == 0) {
+      collider->SetCollisionMask(ng::CollisionLayer::kDefault);
+    }
+    colliders_.push_back(collider);
+  }
+
+  /// @brief Returns a random point of the world.
+  sf::Vector2f GetRandomPoint() {
+    std::uniform_real_distribution<float> coordinate(0.F, kWorldSize);
+    return {coordinate(random_), coordinate(random_)};
+  }
+
+  /// @brief Moves, adds, removes and changes the layers of colliders, then runs a tick to apply the changes.
+  ///        Some moves stay within the margin of the dynamic tree and others teleport colliders, so that leaves are both kept and reinserted.
+  void ChangeWorld() {
+    std::uniform_real_distribution<float> nudge(-4.F, 4.F);
+    for (ng::Collider* collider : colliders_) {
+      switch (random_() % 6) {
+        case 0:
+          collider->Translate({nudge(random_), nudge(random_)});
+          break;
+        case 1:
+          collider->SetLocalPosition(GetRandomPoint());
+          break;
+        default:
+          break;
+      }
+    }
+
+    for (int i = 0; i < 4; ++i) {
+      ng::Collider* collider = colliders_[random_() % colliders_.size()];
+      collider->SetCollisionCategory(random_() % 2 == 0
+                                         ? ng::CollisionLayer::kDefault
+                                         : kSecondLayer);
+    }
+
+    for (int i = 0; i < 10; ++i) {
+      size_t index = random_() % colliders_.size();
+      ng::Collider* collider = colliders_[index];
+      // The parent of a removed collider is not notified of the end of its
+      // contacts, only the other colliders are.
+      std::erase_if(recorder_->contacts, [collider](const auto& contact) {
+        return contact.first == collider;
+      });
+      collider->Destroy();
+      colliders_.erase(colliders_.begin() +
+                       static_cast<std::ptrdiff_t>(index));
+    }
+    for (int i = 0; i < 10; ++i) {
+      AddCollider();
+    }
+
+    app_.RunTicks(1);
+  }
+
+  /// @brief Returns the colliders of the world overlapping a collider, by testing every collider.
+  /// @param collider The collider to test, in the world or not.
+  /// @return The overlapping colliders, sorted by address.
+  [[nodiscard]] std::vector<const ng::Collider*> FindOverlapsBruteForce(
+      const ng::Collider& collider) const {
+    std::vector<const ng::Collider*> overlaps;
+    for (const ng::Collider* other : colliders_) {
+      if (other != &collider && collider.CanCollideWith(*other) &&
+          collider.Collides(*other)) {
+        overlaps.push_back(other);
+      }
+    }
+    std::ranges::sort(overlaps);
+    return overlaps;
+  }
+
+  /// @brief Checks every overlap query of the physics world for a collider against the brute-force result.
+  /// @param collider The collider to query, in the world or not.
+  void ExpectOverlapsMatchBruteForce(const ng::Collider& collider) const {
+    const ng::Physics& physics = scene_->GetPhysics();
+    std::vector<const ng::Collider*> expected =
+        FindOverlapsBruteForce(collider);
+
+    std::vector<const ng::Collider*> found = physics.Overlap(collider);
+    std::vector<const ng::Collider*> sorted_found = found;
+    std::ranges::sort(sorted_found);
+    EXPECT_EQ(sorted_found, expected);
+
+    std::vector<const ng::Collider*> appended = {nullptr};
+    physics.Overlap(collider, appended);
+    EXPECT_EQ(appended.size(), found.size() + 1);
+    EXPECT_TRUE(std::ranges::equal(std::span(appended).subspan(1), found));
+
+    std::array<const ng::Collider*, 2> buffer{};
+    size_t count = physics.Overlap(collider, std::span(buffer));
+    EXPECT_EQ(count, found.size());
+    for (size_t i = 0; i < std::min(count, buffer.size()); ++i) {
+      EXPECT_EQ(buffer[i], found[i]);
+    }
+
+    std::vector<const ng::Collider*> visited;
+    physics.ForEachOverlap(collider, [&visited](const ng::Collider& other) {
+      visited.push_back(&other);
+    });
+    EXPECT_EQ(visited, found);
+
+    EXPECT_EQ(physics.AnyOverlap(collider), !expected.empty());
+  }
+
+  /// @brief Returns the colliders of the world whose category shares a layer with a mask and that overlap a collider, by testing every collider.
+  /// @param probe The collider standing for the queried shape, outside the world.
+  /// @param mask The collision layers of the colliders to report.
+  /// @return The overlapping colliders, sorted by address.
+  [[nodiscard]] std::vector<const ng::Collider*> FindShapeOverlapsBruteForce(
+      const ng::Collider& probe, ng::CollisionLayer mask) const {
+    std::vector<const ng::Collider*> overlaps;
+    for (const ng::Collider* other : colliders_) {
+      if (ng::Intersects(other->GetCollisionCategory(), mask) &&
+          probe.Collides(*other)) {
+        overlaps.push_back(other);
+      }
+    }
+    std::ranges::sort(overlaps);
+    return overlaps;
+  }
+
+  /// @brief Checks that QueryNearest finds the colliders nearest to a point, for several counts and maximum distances, by measuring every collider.
+  /// @param point The world space point.
+  /// @param mask The collision layers of the colliders to find.
+  void ExpectNearestMatchesBruteForce(sf::Vector2f point,
+                                      ng::CollisionLayer mask) const {
+    static constexpr float kInfinity = std::numeric_limits<float>::infinity();
+    // Up to more colliders than the world holds.
+    for (size_t count : {1U, 4U, 16U, 1000U}) {
+      for (float max_distance : {kInfinity, 60.F, 0.F}) {
+        std::vector<float> expected;
+        for (const ng::Collider* collider : colliders_) {
+          float distance = GetDistance(collider->GetGlobalShape(), point);
+          if (ng::Intersects(collider->GetCollisionCategory(), mask) &&
+              distance <= max_distance) {
+            expected.push_back(distance);
+          }
+        }
+        std::ranges::sort(expected);
+        expected.resize(std::min(expected.size(), count));
+
+        std::vector<const ng::Collider*> found;
+        scene_->GetPhysics().QueryNearest(point, count, max_distance, mask,
+                                          found);
+        // Colliders at the maximum distance may be rounded out.
+        ASSERT_NEAR(static_cast<float>(found.size()),
+                    static_cast<float>(expected.size()),
+                    max_distance == kInfinity ? 0.F : 1.F);
+        for (size_t i = 0; i < std::min(found.size(), expected.size()); ++i) {
+          EXPECT_TRUE(ng::Intersects(found[i]->GetCollisionCategory(), mask));
+          // The physics world measures the shapes of its collider store,
+          // rebuilt from their bounds, so the distances differ by rounding,
+          // which grows with the distance.
+          EXPECT_NEAR(GetDistance(found[i]->GetGlobalShape(), point),
+                      expected[i], 1e-2F + expected[i] * 1e-6F);
+        }
+      }
+    }
+  }
+
+  ng::App app_{kTps};
+  ng::Scene* scene_ = nullptr;
+  ContactRecorder* recorder_ = nullptr;
+  // The colliders of the world, including the ones joining it on the next tick.
+  std::vector<ng::Collider*> colliders_;
+  std::minstd_rand random_{42};
+};
+
+TEST_P(PhysicsTest, ContactsMatchBruteForce) {
+  for (int round = 0; round < kRoundCount; ++round) {
+    ChangeWorld();
+
+    std::set<std::pair<const ng::Collider*, const ng::Collider*>> expected;
+    for (const ng::Collider* collider : colliders_) {
+      for (const ng::Collider* other : FindOverlapsBruteForce(*collider)) {
+        expected.insert({collider, other});
+      }
+    }
+    EXPECT_EQ(recorder_->contacts, expected) << "round " << round;
+  }
+}
+
+TEST_P(PhysicsTest, OverlapMatchesBruteForce) {
+  ng::CircleCollider outside_circle(&app_, 40.F);
+  ng::RectangleCollider outside_rectangle(&app_, {60.F, 20.F});
+  for (int round = 0; round < kRoundCount; ++round) {
+    ChangeWorld();
+
+    for (const ng::Collider* collider : colliders_) {
+      ExpectOverlapsMatchBruteForce(*collider);
+    }
+    // Colliders outside the physics world have no stored shape.
+    for (int i = 0; i < 20; ++i) {
+      outside_circle.SetLocalPosition(GetRandomPoint());
+      ExpectOverlapsMatchBruteForce(outside_circle);
+      outside_rectangle.SetLocalPosition(GetRandomPoint());
+      ExpectOverlapsMatchBruteForce(outside_rectangle);
+    }
+  }
+}
+
+TEST_P(PhysicsTest, SweepMatchesBruteForce) {
+  const ng::Physics& physics = scene_->GetPhysics();
+  ng::CircleCollider bullet(&app_, 4.F);
+  std::uniform_real_distribution<float> displacement(-300.F, 300.F);
+  for (int round = 0; round < kRoundCount; ++round) {
+    ChangeWorld();
+
+    for (int i = 0; i < 100; ++i) {
+      bullet.SetLocalPosition(GetRandomPoint());
+      bullet.SetCollisionMask(i % 3 == 0 ? ng::CollisionLayer::kDefault
+                                         : ng::CollisionLayer::kAll);
+      sf::Vector2f move = {displacement(random_), displacement(random_)};
+
+      std::optional<float> expected_time;
+      for (const ng::Collider* collider : colliders_) {
+        if (!bullet.CanCollideWith(*collider)) {
+          continue;
+        }
+        std::optional<ng::SweepContact> contact = ng::SweepShape(
+            bullet.GetGlobalShape(), move, collider->GetGlobalShape());
+        if (contact && (!expected_time || contact->time < *expected_time)) {
+          expected_time = contact->time;
+        }
+      }
+
+      std::optional<ng::ColliderSweepHit> hit = physics.Sweep(bullet, move);
+      ASSERT_EQ(hit.has_value(), expected_time.has_value());
+      // The physics world sweeps against the shapes of its collider store,
+      // rebuilt from their bounds, so the times differ by rounding.
+      if (hit) {
+        EXPECT_NEAR(hit->time, *expected_time, 1e-4F);
+      }
+    }
+  }
+}
+
+TEST_P(PhysicsTest, ShapeQueriesMatchBruteForce) {
+  const ng::Physics& physics = scene_->GetPhysics();
+  // Colliders outside the world stand for the queried shapes.
+  ng::RectangleCollider box(&app_, {120.F, 50.F});
+  ng::CircleCollider circle(&app_, 70.F);
+  ng::RectangleCollider point(&app_, {0.F, 0.F});
+  for (int round = 0; round < kRoundCount; ++round) {
+    ChangeWorld();
+
+    for (int i = 0; i < 100; ++i) {
+      ng::CollisionLayer mask =
+          i % 2 == 0 ? ng::CollisionLayer::kAll : kSecondLayer;
+      box.SetLocalPosition(GetRandomPoint());
+      circle.SetLocalPosition(GetRandomPoint());
+      // Some points lie on colliders, to find more than one collider.
+      point.SetLocalPosition(
+          i % 4 == 0 ? colliders_[i]->GetGlobalShape().center
+                     : GetRandomPoint());
+
+      std::vector<const ng::Collider*> found;
+      physics.QueryAABB(box.GetGlobalBounds(), mask, found);
+      std::ranges::sort(found);
+      EXPECT_EQ(found, FindShapeOverlapsBruteForce(box, mask));
+
+      found.clear();
+      physics.QueryCircle(circle.GetGlobalShape().center, 70.F, mask, found);
+      std::ranges::sort(found);
+      EXPECT_EQ(found, FindShapeOverlapsBruteForce(circle, mask));
+
+      found.clear();
+      physics.QueryPoint(point.GetGlobalShape().center, mask, found);
+      std::ranges::sort(found);
+      EXPECT_EQ(found, FindShapeOverlapsBruteForce(point, mask));
+    }
+  }
+}
+
+TEST_P(PhysicsTest, QueryNearestMatchesBruteForce) {
+  for (int round = 0; round < kRoundCount; ++round) {
+    ChangeWorld();
+
+    for (int i = 0; i < 60; ++i) {
+      // Points inside colliders, in the world, and far enough from it that
+      // the search squares grow until the scan takes over.
+      sf::Vector2f point = GetRandomPoint();
+      if (i % 3 == 0) {
+        point = colliders_[i]->GetGlobalShape().center;
+      } else if (i % 3 == 1) {
+        point *= 1000.F;
+      }
+      ExpectNearestMatchesBruteForce(point, i % 2 == 0
+                                                ? ng::CollisionLayer::kAll
+                                                : kSecondLayer);
+    }
+  }
+}
+
+TEST_P(PhysicsTest, OverlapMatchesBruteForceInSmallWorlds) {
+  // Down to a single collider, crowded enough to overlap.
+  while (colliders_.size() > 1) {
+    if (colliders_.size() <= 40) {
+      for (ng::Collider* collider : colliders_) {
+        collider->SetLocalPosition(GetRandomPoint() / 8.F);
+      }
+      app_.RunTicks(1);
+      for (const ng::Collider* collider : colliders_) {
+        ExpectOverlapsMatchBruteForce(*collider);
+      }
+    }
+
+    colliders_.back()->Destroy();
+    colliders_.pop_back();
+    app_.RunTicks(1);
+  }
+}
+
+TEST_P(PhysicsTest, QueryNearestMatchesBruteForceInSmallWorlds) {
+  // Down to a single collider, then none.
+  while (!colliders_.empty()) {
+    if (colliders_.size() <= 40) {
+      for (int i = 0; i < 10; ++i) {
+        ExpectNearestMatchesBruteForce(GetRandomPoint(),
+                                       ng::CollisionLayer::kAll);
+      }
+    }
+
+    colliders_.back()->Destroy();
+    colliders_.pop_back();
+    app_.RunTicks(1);
+  }
+  ExpectNearestMatchesBruteForce(GetRandomPoint(), ng::CollisionLayer::kAll);
+}
+
+INSTANTIATE_TEST_SUITE_P(Broadphases, PhysicsTest,
+                         ng_test::kAllBroadphases,
+                         ng_test::GetBroadphaseName);
+
+}  // namespace
\ No newline at end of file